@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ray.h"
+#include "utils.h"
+#include <algorithm>
+
+/**
+ * @class aabb
+ * @brief Caixa delimitadora alinhada aos eixos (axis-aligned bounding box)
+ *
+ * Uma caixa vazia tem `minimum = +infinito` e `maximum = -infinito`, de modo
+ * que `expand` com qualquer ponto ou caixa produz o resultado correto.
+ */
+class aabb {
+public:
+    /// Caixa vazia
+    aabb() : minimum(infinity, infinity, infinity), maximum(-infinity, -infinity, -infinity) {}
+
+    aabb(const point3& a, const point3& b) : minimum(a), maximum(b) {}
+
+    const point3& min() const { return minimum; }
+    const point3& max() const { return maximum; }
+
+    /// Aumenta a caixa para conter `p`
+    void expand(const point3& p) {
+        for (int a = 0; a < 3; ++a) {
+            minimum.e[a] = std::min(minimum.e[a], p.e[a]);
+            maximum.e[a] = std::max(maximum.e[a], p.e[a]);
+        }
+    }
+
+    /// Aumenta a caixa para conter `box`
+    void expand(const aabb& box) {
+        expand(box.minimum);
+        expand(box.maximum);
+    }
+
+    /// Centro da caixa
+    point3 centroid() const { return 0.5 * (minimum + maximum); }
+
+    /// Eixo (0, 1 ou 2) em que a caixa é mais longa
+    int longest_axis() const {
+        vec3 d = maximum - minimum;
+        if (d.x() > d.y() && d.x() > d.z()) return 0;
+        return d.y() > d.z() ? 1 : 2;
+    }
+
+    /// Área da superfície (zero para caixa vazia)
+    double surface_area() const {
+        vec3 d = maximum - minimum;
+        if (d.x() < 0 || d.y() < 0 || d.z() < 0) return 0;
+        return 2 * (d.x() * d.y() + d.y() * d.z() + d.z() * d.x());
+    }
+
+    /**
+     * @brief Teste de interseção raio-caixa pelo método das placas (slabs)
+     *
+     * @param r Raio
+     * @param inv_dir Inverso de cada componente da direção do raio
+     * @param t_min Início do intervalo
+     * @param t_max Fim do intervalo
+     * @param t_enter Recebe o t de entrada na caixa
+     * @return true se o raio cruza a caixa dentro de `[t_min, t_max]`
+     */
+    bool hit(const ray& r, const vec3& inv_dir, double t_min, double t_max, double& t_enter) const {
+        for (int a = 0; a < 3; ++a) {
+            double t0 = (minimum[a] - r.origin()[a]) * inv_dir[a];
+            double t1 = (maximum[a] - r.origin()[a]) * inv_dir[a];
+            if (inv_dir[a] < 0) std::swap(t0, t1);
+            t_min = t0 > t_min ? t0 : t_min;
+            t_max = t1 < t_max ? t1 : t_max;
+            if (t_max < t_min) return false;
+        }
+        t_enter = t_min;
+        return true;
+    }
+
+private:
+    point3 minimum;
+    point3 maximum;
+};
+
+/**
+ * @brief Menor caixa que contém as duas caixas
+ */
+inline aabb surrounding_box(const aabb& a, const aabb& b) {
+    aabb box = a;
+    box.expand(b);
+    return box;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "color.h"
+#include "tiles.h"
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @class AccumulationBuffer
+ * @brief Acumula progressivamente as amostras de cada pixel
+ *
+ * Para cada pixel são guardados:
+ * - a soma das amostras (`r`, `g`, `b`), em float
+ * - o número de amostras acumuladas (`count`)
+ * - a distância da câmera ao primeiro hit do raio central (`depth`),
+ *   usada pela reprojeção temporal; `infinity` indica o céu
+ *
+ * A imagem é dividida em tiles quadrados de `tile_size` pixels (potência de 2).
+ * Cada tile ocupa um bloco contíguo dos vetores, e os blocos seguem a ordem em
+ * que os tiles são renderizados (`tiles`). Assim os pixels de um tile ficam
+ * nas mesmas linhas de cache; a conversão para a ordem linear da janela só
+ * acontece ao apresentar a imagem. Os tiles da borda são completados com
+ * pixels de preenchimento que nunca recebem amostras.
+ *
+ * Os pixels são indexados como em `Renderer`: `j = 0` é a linha de baixo.
+ */
+class AccumulationBuffer {
+public:
+    /// `tile_size` é arredondado para cima até a próxima potência de 2 (`index` depende disso)
+    AccumulationBuffer(int width, int height, int tile_size = 8, TileOrder order = TileOrder::Morton)
+        : width(width), height(height), order(order)
+    {
+        while ((1 << tile_shift) < tile_size) ++tile_shift;
+        tile_size = 1 << tile_shift;
+        this->tile_size = tile_size;
+        tiles_x = (width + tile_size - 1) / tile_size;
+        int tiles_y = (height + tile_size - 1) / tile_size;
+
+        // Posição de cada tile na memória = posição na ordem de percurso
+        tile_slot.resize(tiles_x * tiles_y);
+        std::vector<int> ids = tile_order(tiles_x, tiles_y, order);
+        for (size_t slot = 0; slot < ids.size(); ++slot) {
+            int tx = ids[slot] % tiles_x;
+            int ty = ids[slot] / tiles_x;
+            tile_slot[ids[slot]] = static_cast<int>(slot);
+            tiles.push_back({tx * tile_size, ty * tile_size,
+                             std::min((tx + 1) * tile_size, width),
+                             std::min((ty + 1) * tile_size, height)});
+        }
+
+        size_t padded = tiles.size() * tile_size * tile_size;
+        r.resize(padded); g.resize(padded); b.resize(padded);
+        count.resize(padded); depth.resize(padded);
+        clear();
+    }
+
+    /// Índice do pixel (i, j) nos vetores
+    int index(int i, int j) const {
+        int tile = tile_slot[(j >> tile_shift) * tiles_x + (i >> tile_shift)];
+        int local = ((j & (tile_size - 1)) << tile_shift) | (i & (tile_size - 1));
+        return (tile << (2 * tile_shift)) | local;
+    }
+
+    /// Soma uma amostra ao pixel
+    void add_sample(int idx, const color& c) {
+        r[idx] += static_cast<float>(c.x());
+        g[idx] += static_cast<float>(c.y());
+        b[idx] += static_cast<float>(c.z());
+        count[idx]++;
+    }
+
+    /// Soma acumulada do pixel (dividir por `count` para obter a média)
+    color sum(int idx) const { return color(r[idx], g[idx], b[idx]); }
+
+    /// Descarta o histórico de um pixel
+    void reset(int idx) {
+        r[idx] = g[idx] = b[idx] = 0.0f;
+        count[idx] = 0;
+        depth[idx] = std::numeric_limits<float>::infinity();
+    }
+
+    /// Descarta o histórico de todos os pixels
+    void clear() {
+        for (size_t idx = 0; idx < count.size(); ++idx) reset(static_cast<int>(idx));
+    }
+
+public:
+    int width, height;
+    int tile_size;
+    TileOrder order;
+    std::vector<Tile> tiles; // Na ordem de percurso (e de memória)
+
+    std::vector<float> r, g, b;
+    std::vector<uint32_t> count;
+    std::vector<float> depth;
+
+private:
+    int tile_shift = 0;
+    int tiles_x;
+    std::vector<int> tile_slot; // Tile (tx + ty * tiles_x) -> posição na memória
+};
@@ -0,0 +1,295 @@
+#include "animation.h"
+#include "renderer.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+/**
+ * @brief Nome do arquivo do quadro `frame`
+ *
+ * O número entra no lugar de um `%d` (`%04d`, `%4d`...); `%%` vira `%`. O
+ * padrão é lido aqui, nunca passado ao printf: vem da linha de comando. Um
+ * padrão sem `%d` ganha `_0000` antes da extensão.
+ *
+ * @return false se o padrão tiver outro `%` ou mais de um `%d`
+ */
+bool frame_path(const std::string& pattern, int frame, std::string& path) {
+    // Como o printf: zeros entre o sinal e os dígitos, espaços antes do sinal
+    auto number = [frame](size_t width, char fill) {
+        std::string sign = frame < 0 ? "-" : "";
+        std::string digits = std::to_string(frame < 0 ? -static_cast<long long>(frame) : frame);
+        size_t pad = width > sign.size() + digits.size() ? width - sign.size() - digits.size() : 0;
+        return fill == '0' ? sign + std::string(pad, '0') + digits : std::string(pad, ' ') + sign + digits;
+    };
+
+    path.clear();
+    bool numbered = false;
+    for (size_t k = 0; k < pattern.size(); ++k) {
+        if (pattern[k] != '%') {
+            path += pattern[k];
+            continue;
+        }
+        if (k + 1 < pattern.size() && pattern[k + 1] == '%') {
+            path += '%';
+            ++k;
+            continue;
+        }
+
+        // %[0][largura]d, largura até 2 dígitos
+        size_t end = k + 1;
+        char fill = ' ';
+        if (end < pattern.size() && pattern[end] == '0') {
+            fill = '0';
+            ++end;
+        }
+        size_t width = 0, digits = 0;
+        for (; end < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[end])) && digits < 2; ++end, ++digits)
+            width = 10 * width + static_cast<size_t>(pattern[end] - '0');
+        if (numbered || end >= pattern.size() || pattern[end] != 'd') return false;
+
+        path += number(width, fill);
+        numbered = true;
+        k = end;
+    }
+
+    if (!numbered) {
+        size_t dot = path.rfind('.');
+        size_t slash = path.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) dot = path.size();
+        path.insert(dot, "_" + number(4, '0'));
+    }
+    return true;
+}
+
+bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+bool CameraPath::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Erro ao abrir o caminho da câmera: " << path << std::endl;
+        return false;
+    }
+
+    keys.clear();
+    std::string line;
+    for (int number = 1; std::getline(in, line); ++number) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        std::istringstream fields(line);
+        double frame, x, y, z;
+        if (!(fields >> frame >> x >> y >> z)) {
+            std::cerr << path << ":" << number << ": esperado `<quadro> <x> <y> <z>`" << std::endl;
+            return false;
+        }
+        add(frame, point3(x, y, z));
+    }
+
+    if (keys.empty()) {
+        std::cerr << "Nenhum quadro-chave em " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void CameraPath::add(double frame, const point3& position) {
+    auto at = std::upper_bound(keys.begin(), keys.end(), frame,
+                               [](double f, const CameraKeyframe& k) { return f < k.frame; });
+    keys.insert(at, {frame, position});
+}
+
+point3 CameraPath::position(double frame) const {
+    if (keys.empty()) return point3(0, 0, 0);
+    if (frame <= keys.front().frame) return keys.front().position;
+    if (frame >= keys.back().frame) return keys.back().position;
+
+    size_t i = std::upper_bound(keys.begin(), keys.end(), frame,
+                                [](double f, const CameraKeyframe& k) { return f < k.frame; }) - keys.begin() - 1;
+    const CameraKeyframe& k0 = keys[i];
+    const CameraKeyframe& k1 = keys[i + 1];
+    const double h = k1.frame - k0.frame;
+    if (h <= 0) return k1.position;
+
+    // Velocidade (por quadro) em cada quadro-chave: diferença entre os vizinhos;
+    // nas pontas, só o lado que existe
+    auto velocity = [this](size_t k) {
+        size_t a = k > 0 ? k - 1 : k;
+        size_t b = k + 1 < keys.size() ? k + 1 : k;
+        double dt = keys[b].frame - keys[a].frame;
+        return dt > 0 ? (keys[b].position - keys[a].position) / dt : vec3(0, 0, 0);
+    };
+    const vec3 m0 = velocity(i) * h;
+    const vec3 m1 = velocity(i + 1) * h;
+
+    const double s = (frame - k0.frame) / h;
+    const double s2 = s * s, s3 = s2 * s;
+    return (2*s3 - 3*s2 + 1) * k0.position + (s3 - 2*s2 + s) * m0
+         + (-2*s3 + 3*s2) * k1.position + (s3 - s2) * m1;
+}
+
+FrameWriter::FrameWriter(int width, int height, Tonemap op)
+    : op(op), staging(width, height), current(width, height)
+{
+    worker = std::thread(&FrameWriter::run, this);
+}
+
+FrameWriter::~FrameWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void FrameWriter::submit(const AccumulationBuffer& image, const std::string& path) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        // Um quadro por vez na fila: espera o anterior sair da área de espera
+        if (pending) {
+            auto start = std::chrono::steady_clock::now();
+            done.wait(lock, [this] { return !pending; });
+            stalled += seconds_since(start);
+        }
+        staging = image;
+        staging_path = path;
+        pending = true;
+    }
+    wake.notify_one();
+}
+
+void FrameWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return !pending && !writing; });
+}
+
+bool FrameWriter::failed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+}
+
+void FrameWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return pending || stop; });
+        if (!pending && stop) break;
+
+        std::swap(staging, current);
+        std::swap(staging_path, current_path);
+        pending = false;
+        writing = true;
+        done.notify_all();
+
+        lock.unlock();
+        bool ok = save_frame(current_path, current, op, pixels);
+        lock.lock();
+
+        error = error || !ok;
+        writing = false;
+        done.notify_all();
+    }
+}
+
+bool save_frame(const std::string& path, const AccumulationBuffer& image, Tonemap op,
+                std::vector<uint32_t>& pixels) {
+    // Escreve num arquivo temporário e renomeia: quem acompanha a pasta de
+    // saída nunca vê um quadro pela metade
+    std::string tmp_path = path + ".tmp";
+    std::FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Erro ao gravar o quadro: " << tmp_path << std::endl;
+        return false;
+    }
+
+    bool ok;
+    if (ends_with(path, ".pfm")) {
+        // PFM: float RGB linear, linhas de baixo para cima (como `j`), little-endian
+        std::fprintf(file, "PF\n%d %d\n-1.0\n", image.width, image.height);
+        std::vector<float> row(3 * static_cast<size_t>(image.width));
+        ok = true;
+        for (int j = 0; j < image.height && ok; ++j) {
+            for (int i = 0; i < image.width; ++i) {
+                int idx = image.index(i, j);
+                float scale = image.count[idx] ? 1.0f / image.count[idx] : 0.0f;
+                row[3*i + 0] = image.r[idx] * scale;
+                row[3*i + 1] = image.g[idx] * scale;
+                row[3*i + 2] = image.b[idx] * scale;
+            }
+            ok = std::fwrite(row.data(), sizeof(float), row.size(), file) == row.size();
+        }
+    } else {
+        // PPM binário, pelo mesmo resolve da janela
+        pixels.resize(static_cast<size_t>(image.width) * image.height);
+        resolve(image, op, 1, pixels.data(), 1);
+        std::fprintf(file, "P6\n%d %d\n255\n", image.width, image.height);
+        std::vector<uint8_t> bytes(3 * pixels.size());
+        for (size_t k = 0; k < pixels.size(); ++k) {
+            bytes[3*k + 0] = static_cast<uint8_t>(pixels[k] >> 16);
+            bytes[3*k + 1] = static_cast<uint8_t>(pixels[k] >> 8);
+            bytes[3*k + 2] = static_cast<uint8_t>(pixels[k]);
+        }
+        ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    }
+
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::cerr << "Erro ao gravar o quadro: " << path << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+AnimationStats render_animation(Renderer& engine, const hittable& scene, const camera& cam,
+                                const Integrator& integrator, const RenderSettings& settings,
+                                const CameraPath& path, int first, int count, const std::string& pattern) {
+    AnimationStats stats;
+    std::string file;
+    if (!frame_path(pattern, first, file)) {
+        std::cerr << "Padrão de nome de quadro inválido: " << pattern
+                  << " (use um único %d, como em quadro_%04d.ppm, e %% para um % literal)" << std::endl;
+        stats.failed = true;
+        return stats;
+    }
+
+    const int height = static_cast<int>(settings.image_width / settings.aspect_ratio);
+    FrameWriter writer(settings.image_width, height, settings.tonemap);
+    camera frame_cam = cam;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int k = first; k < first + count; ++k) {
+        frame_cam.set_position(path.position(k));
+
+        const auto frame_start = std::chrono::steady_clock::now();
+        RenderJob job = engine.submit(scene, frame_cam, integrator, settings);
+        job.wait();
+        const double seconds = seconds_since(frame_start);
+        stats.render += seconds;
+        stats.frames++;
+
+        // A gravação deste quadro roda junto com o render do próximo
+        frame_path(pattern, k, file);
+        writer.submit(job.result().image, file);
+        std::printf("Quadro %d: %.2f s -> %s\n", k, seconds, file.c_str());
+        std::fflush(stdout);
+    }
+    writer.flush();
+
+    stats.total = seconds_since(start);
+    stats.stalled = writer.stall_seconds();
+    stats.failed = writer.failed();
+    return stats;
+}
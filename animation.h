@@ -0,0 +1,152 @@
+#pragma once
+
+#include "accumulation.h"
+#include "resolve.h"
+#include "vec3.h"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Renderer;
+class hittable;
+class camera;
+class Integrator;
+struct RenderSettings;
+
+/**
+ * @struct CameraKeyframe
+ * @brief Posição da câmera num quadro da animação
+ */
+struct CameraKeyframe {
+    double frame;
+    point3 position;
+};
+
+/**
+ * @class CameraPath
+ * @brief Trajetória da câmera dada por quadros-chave
+ *
+ * Entre dois quadros-chave a posição segue uma curva de Hermite com as
+ * tangentes de Catmull-Rom (diferença entre os vizinhos, dividida pelo
+ * intervalo de quadros entre eles): a câmera passa por todos os quadros-chave
+ * sem mudar de velocidade de repente. Antes do primeiro e depois do último
+ * ela fica parada.
+ */
+class CameraPath {
+public:
+    /**
+     * @brief Lê um arquivo com uma linha `<quadro> <x> <y> <z>` por quadro-chave
+     *
+     * Linhas vazias e começadas por `#` são ignoradas; os quadros-chave podem
+     * vir em qualquer ordem.
+     *
+     * @return false se o arquivo não abrir, tiver uma linha inválida ou nenhum quadro-chave
+     */
+    bool load(const std::string& path);
+
+    /// Adiciona um quadro-chave (mantém a ordem por quadro)
+    void add(double frame, const point3& position);
+
+    /// Posição da câmera no quadro `frame` (pode ser fracionário)
+    point3 position(double frame) const;
+
+    bool empty() const { return keys.empty(); }
+
+    /// Quadro do último quadro-chave
+    double last_frame() const { return keys.empty() ? 0 : keys.back().frame; }
+
+private:
+    std::vector<CameraKeyframe> keys;
+};
+
+/**
+ * @class FrameWriter
+ * @brief Converte e grava os quadros de uma animação numa thread de I/O
+ *
+ * `submit` entrega o acúmulo de um quadro e retorna logo; a conversão e a
+ * escrita acontecem enquanto o quadro seguinte é renderizado. Ao contrário
+ * dos checkpoints, nenhum quadro é descartado: se a gravação anterior ainda
+ * estiver na fila, `submit` espera por ela.
+ *
+ * A extensão do arquivo escolhe o formato: `.pfm` grava a média das amostras
+ * em float (linear, sem tonemap); qualquer outra, PPM binário (P6) com `op`.
+ */
+class FrameWriter {
+public:
+    FrameWriter(int width, int height, Tonemap op);
+
+    /// Grava o que estiver na fila e encerra a thread
+    ~FrameWriter();
+
+    /// Copia `image` para a fila e agenda a gravação em `path`
+    void submit(const AccumulationBuffer& image, const std::string& path);
+
+    /// Bloqueia até todos os quadros agendados estarem gravados
+    void flush();
+
+    /// Algum quadro falhou ao ser gravado
+    bool failed() const;
+
+    /// Tempo que `submit` passou esperando a thread de I/O, em segundos
+    double stall_seconds() const { return stalled; }
+
+private:
+    void run();
+
+    const Tonemap op;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool pending = false;  // Há um quadro na área de espera
+    bool writing = false;  // A thread de I/O está gravando
+    bool stop = false;
+    bool error = false;
+    double stalled = 0;
+
+    AccumulationBuffer staging;       // Preenchido pelo render
+    std::string staging_path;
+    AccumulationBuffer current;       // Sendo gravado pela thread de I/O
+    std::string current_path;
+    std::vector<uint32_t> pixels;     // Só a thread de I/O mexe
+
+    std::thread worker;
+};
+
+/**
+ * @brief Grava a média das amostras como PPM binário (P6) ou PFM, pela extensão
+ * @return false se o arquivo não pôde ser gravado
+ */
+bool save_frame(const std::string& path, const AccumulationBuffer& image, Tonemap op,
+                std::vector<uint32_t>& pixels);
+
+/**
+ * @struct AnimationStats
+ * @brief Tempos de `render_animation`, em segundos
+ */
+struct AnimationStats {
+    int frames = 0;
+    double render = 0;  // Soma dos renders dos quadros
+    double total = 0;   // Do primeiro render até o último arquivo gravado
+    double stalled = 0; // Render parado esperando a gravação
+    bool failed = false; // Algum quadro não pôde ser gravado
+};
+
+/**
+ * @brief Renderiza os quadros `[first, first + count)` de uma animação num processo só
+ *
+ * A cena, a BVH e o integrador são os mesmos em todos os quadros; só a
+ * posição da câmera muda, seguindo `path`. Cada quadro é um job de
+ * `Renderer::submit`, e a gravação do quadro k (`FrameWriter`) acontece
+ * durante o render do quadro k + 1.
+ *
+ * @param pattern Nome dos arquivos, com o número do quadro no lugar de um
+ *        `%d`/`%04d` (ex.: `quadro_%04d.ppm`; `%%` é um `%` literal); sem
+ *        `%d`, o número entra antes da extensão
+ * @return `failed` sem renderizar nada se `pattern` for inválido
+ */
+AnimationStats render_animation(Renderer& engine, const hittable& scene, const camera& cam,
+                                const Integrator& integrator, const RenderSettings& settings,
+                                const CameraPath& path, int first, int count, const std::string& pattern);
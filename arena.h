@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @class Arena
+ * @brief Alocador por incremento de ponteiro (bump allocator)
+ *
+ * Reserva blocos grandes e entrega pedaços consecutivos deles, sem cabeçalho
+ * por objeto. Não há liberação individual: tudo é destruído junto com a arena.
+ * Objetos com destrutor não trivial criados com `create` são destruídos na
+ * ordem inversa da criação.
+ */
+class Arena {
+public:
+    explicit Arena(size_t block_size = 1 << 20) : block_size(block_size) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    Arena(Arena&& other) noexcept { *this = std::move(other); }
+
+    Arena& operator=(Arena&& other) noexcept {
+        if (this != &other) {
+            release();
+            block_size = other.block_size;
+            blocks = std::move(other.blocks);
+            destructors = std::move(other.destructors);
+            cursor = other.cursor;
+            remaining = other.remaining;
+            used = other.used;
+            reserved = other.reserved;
+            other.blocks.clear();
+            other.destructors.clear();
+            other.cursor = nullptr;
+            other.remaining = 0;
+            other.used = 0;
+            other.reserved = 0;
+        }
+        return *this;
+    }
+
+    ~Arena() { release(); }
+
+    /**
+     * @brief Reserva `bytes` bytes com o alinhamento pedido
+     */
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment;
+        if (padding + bytes > remaining) {
+            // Bloco novo (objetos maiores que o bloco ganham um bloco só para eles)
+            size_t size = std::max(block_size, bytes + alignment);
+            blocks.emplace_back(new char[size]); // Sem zerar a memória
+            cursor = blocks.back().get();
+            remaining = size;
+            reserved += size;
+            padding = (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment;
+        }
+
+        char* p = cursor + padding;
+        cursor = p + bytes;
+        remaining -= padding + bytes;
+        used += padding + bytes;
+        return p;
+    }
+
+    /**
+     * @brief Constrói um objeto dentro da arena
+     */
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value)
+            destructors.push_back({object, [](void* p) { static_cast<T*>(p)->~T(); }});
+        return object;
+    }
+
+    /// Bytes entregues até agora (incluindo o preenchimento de alinhamento)
+    size_t bytes_used() const { return used; }
+
+    /// Bytes reservados do sistema
+    size_t bytes_reserved() const { return reserved; }
+
+private:
+    void release() {
+        for (auto it = destructors.rbegin(); it != destructors.rend(); ++it) it->destroy(it->object);
+        destructors.clear();
+        blocks.clear();
+        cursor = nullptr;
+        remaining = 0;
+        used = 0;
+        reserved = 0;
+    }
+
+private:
+    struct Destructor {
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    size_t block_size;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::vector<Destructor> destructors;
+    char* cursor = nullptr;
+    size_t remaining = 0;
+    size_t used = 0;
+    size_t reserved = 0;
+};
+
+/**
+ * @brief Alocador para `std::vector` com alinhamento fixo (ex.: 64 bytes, uma linha de cache)
+ */
+template <typename T, size_t Alignment>
+struct aligned_allocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+    aligned_allocator() = default;
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        // aligned_alloc exige tamanho múltiplo do alinhamento
+        size_t bytes = (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        void* p = std::aligned_alloc(Alignment, bytes);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t) { std::free(p); }
+
+    template <typename U>
+    bool operator==(const aligned_allocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const aligned_allocator<U, Alignment>&) const { return false; }
+};
+
+/// Vetor alinhado a linhas de cache de 64 bytes
+template <typename T>
+using aligned_vector = std::vector<T, aligned_allocator<T, 64>>;
@@ -0,0 +1,487 @@
+#include "bvh.h"
+#include <algorithm>
+#include <thread>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Custos relativos da SAH: atravessar um nó e testar um objeto
+const float traversal_cost = 1.0f;
+const float intersection_cost = 1.0f;
+
+const int bin_count = 16;
+
+// Abaixo desta profundidade a divisão passa a ser pela mediana (limita a pilha da travessia)
+const int max_sah_depth = 64;
+const int stack_size = 128;
+
+// Com menos raios ativos que isto num nó, o pacote segue raio a raio
+const int divergence_threshold = 8;
+
+// Folga relativa dos testes de caixa em float do pacote (caixas nunca são perdidas)
+const float packet_padding = 1.0f / (1 << 20);
+
+// Níveis com menos nós que isto são atualizados numa thread só
+const size_t parallel_grain = 4096;
+
+/**
+ * @brief Divide `[0, count)` em faixas contíguas, uma por thread
+ */
+template <typename F>
+void parallel_for(size_t count, int threads, F f) {
+    if (threads <= 1 || count < parallel_grain) {
+        f(size_t(0), count);
+        return;
+    }
+
+    size_t chunk = (count + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (size_t begin = 0; begin < count; begin += chunk)
+        workers.emplace_back(f, begin, std::min(begin + chunk, count));
+    for (auto& w : workers) w.join();
+}
+
+/**
+ * @brief Raios de `active` que atingem a caixa em `[t_near, t_far[k]]`
+ *
+ * Todos os raios do pacote saem da mesma origem, então `box - origin` é o
+ * mesmo para todos e cada eixo custa duas multiplicações por raio.
+ */
+uint64_t packet_box_hits(const aabb& box, const ray_packet& packet, uint64_t active,
+                         float t_near, const float* t_far) {
+    float lo[3], hi[3];
+    for (int a = 0; a < 3; ++a) {
+        lo[a] = static_cast<float>(box.min()[a] - packet.origin[a]);
+        hi[a] = static_cast<float>(box.max()[a] - packet.origin[a]);
+    }
+    const float* inv[3] = {packet.inv_x, packet.inv_y, packet.inv_z};
+    const float exit_padding = 1 + packet_padding;
+
+    uint64_t result = 0;
+    for (int group = 0; group < ray_packet::max_size / 8; ++group) {
+        const unsigned lanes = static_cast<unsigned>(active >> (8 * group)) & 0xff;
+        if (!lanes) continue;
+        const int first = 8 * group;
+
+#if defined(__AVX2__)
+        __m256 t0 = _mm256_set1_ps(t_near);
+        __m256 t1 = _mm256_load_ps(t_far + first);
+        for (int a = 0; a < 3; ++a) {
+            __m256 id = _mm256_load_ps(inv[a] + first);
+            __m256 ta = _mm256_mul_ps(_mm256_set1_ps(lo[a]), id);
+            __m256 tb = _mm256_mul_ps(_mm256_set1_ps(hi[a]), id);
+            t0 = _mm256_max_ps(t0, _mm256_min_ps(ta, tb));
+            t1 = _mm256_min_ps(t1, _mm256_max_ps(ta, tb));
+        }
+        t1 = _mm256_mul_ps(t1, _mm256_set1_ps(exit_padding));
+        unsigned hits = static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(t0, t1, _CMP_LE_OQ)));
+#else
+        unsigned hits = 0;
+        for (int k = 0; k < 8; ++k) {
+            float t0 = t_near, t1 = t_far[first + k];
+            for (int a = 0; a < 3; ++a) {
+                float ta = lo[a] * inv[a][first + k];
+                float tb = hi[a] * inv[a][first + k];
+                t0 = std::max(t0, std::min(ta, tb));
+                t1 = std::min(t1, std::max(ta, tb));
+            }
+            if (t0 <= t1 * exit_padding) hits |= 1u << k;
+        }
+#endif
+        result |= uint64_t(hits & lanes) << first;
+    }
+    return result;
+}
+
+} // namespace
+
+bvh::bvh(const std::vector<shared_ptr<hittable>>& objects, int max_leaf_size)
+    : objects(objects), max_leaf_size(std::clamp(max_leaf_size, 1, 16))
+{
+    slot_of_object.assign(objects.size(), invalid);
+    for (size_t i = 0; i < objects.size(); ++i) {
+        aabb box;
+        if (objects[i]->bounding_box(box))
+            refs.push_back({box, objects[i].get(), static_cast<uint32_t>(i)});
+        else
+            unbounded.push_back(objects[i]);
+    }
+    leaf_of_slot.assign(refs.size(), invalid);
+
+    rebuild();
+}
+
+void bvh::rebuild() {
+    nodes.clear();
+    dirty_leaves.clear();
+    garbage_nodes = 0;
+    if (refs.empty()) return;
+
+    nodes.reserve(2 * refs.size());
+    nodes.resize(1);
+    build_node(0, 0, static_cast<uint32_t>(refs.size()), invalid, 0);
+}
+
+float bvh::build_node(uint32_t index, uint32_t begin, uint32_t count, uint32_t parent, uint16_t depth) {
+    const uint32_t end = begin + count;
+
+    aabb box, centroids;
+    for (uint32_t k = begin; k < end; ++k) {
+        box.expand(refs[k].box);
+        centroids.expand(refs[k].box.centroid());
+    }
+
+    node& n = nodes[index];
+    n.box = box;
+    n.child = invalid;
+    n.parent = parent;
+    n.prim_begin = begin;
+    n.prim_count = count;
+    n.depth = depth;
+    n.axis = 0;
+    n.dirty = 0;
+
+    if (count <= static_cast<uint32_t>(max_leaf_size)) {
+        for (uint32_t k = begin; k < end; ++k) {
+            leaf_of_slot[k] = index;
+            slot_of_object[refs[k].index] = k;
+        }
+        n.build_cost = n.cost = intersection_cost * count;
+        return n.cost;
+    }
+
+    const int axis = centroids.longest_axis();
+    const double lo = centroids.min()[axis];
+    const double extent = centroids.max()[axis] - lo;
+
+    auto bin_of = [&](const prim_ref& ref) {
+        int b = static_cast<int>(bin_count * (ref.box.centroid()[axis] - lo) / extent);
+        return std::min(b, bin_count - 1);
+    };
+
+    uint32_t mid = begin;
+    if (extent > 0 && depth < max_sah_depth) {
+        // SAH com binning: escolhe o plano entre baixas com menor custo esperado
+        aabb bin_box[bin_count];
+        uint32_t bin_size[bin_count] = {};
+        for (uint32_t k = begin; k < end; ++k) {
+            int b = bin_of(refs[k]);
+            bin_box[b].expand(refs[k].box);
+            bin_size[b]++;
+        }
+
+        double right_area[bin_count];
+        uint32_t right_size[bin_count];
+        aabb acc;
+        uint32_t acc_size = 0;
+        for (int b = bin_count - 1; b > 0; --b) {
+            acc.expand(bin_box[b]);
+            acc_size += bin_size[b];
+            right_area[b] = acc.surface_area();
+            right_size[b] = acc_size;
+        }
+
+        int best = -1;
+        double best_cost = infinity;
+        acc = aabb();
+        acc_size = 0;
+        for (int b = 1; b < bin_count; ++b) {
+            acc.expand(bin_box[b - 1]);
+            acc_size += bin_size[b - 1];
+            if (acc_size == 0 || right_size[b] == 0) continue;
+            double cost = acc.surface_area() * acc_size + right_area[b] * right_size[b];
+            if (cost < best_cost) {
+                best_cost = cost;
+                best = b;
+            }
+        }
+
+        if (best > 0) {
+            auto it = std::partition(refs.begin() + begin, refs.begin() + end,
+                                     [&](const prim_ref& ref) { return bin_of(ref) < best; });
+            mid = static_cast<uint32_t>(it - refs.begin());
+        }
+    }
+
+    if (mid == begin || mid == end) {
+        // Centróides coincidentes ou árvore profunda demais: divide pela mediana
+        mid = begin + count / 2;
+        std::nth_element(refs.begin() + begin, refs.begin() + mid, refs.begin() + end,
+                         [axis](const prim_ref& a, const prim_ref& b) {
+                             return a.box.centroid()[axis] < b.box.centroid()[axis];
+                         });
+    }
+
+    // `n` deixa de valer aqui: o vetor de nós pode ser realocado
+    const uint32_t child = static_cast<uint32_t>(nodes.size());
+    nodes.resize(nodes.size() + 2);
+    nodes[index].child = child;
+    nodes[index].axis = static_cast<uint8_t>(axis);
+
+    build_node(child, begin, mid - begin, index, depth + 1);
+    build_node(child + 1, mid, end - mid, index, depth + 1);
+
+    float cost = node_cost(nodes[index]);
+    nodes[index].build_cost = nodes[index].cost = cost;
+    return cost;
+}
+
+float bvh::node_cost(const node& n) const {
+    if (n.is_leaf()) return intersection_cost * n.prim_count;
+
+    const node& left = nodes[n.child];
+    const node& right = nodes[n.child + 1];
+    double area = n.box.surface_area();
+    if (area <= 0) return traversal_cost + left.cost + right.cost;
+
+    return static_cast<float>(traversal_cost + (left.box.surface_area() * left.cost +
+                                                right.box.surface_area() * right.cost) / area);
+}
+
+void bvh::mark_moved(size_t object_index) {
+    uint32_t slot = slot_of_object[object_index];
+    if (slot == invalid) return; // Objeto sem caixa: fica fora da árvore
+
+    objects[object_index]->bounding_box(refs[slot].box);
+    dirty_leaves.push_back(leaf_of_slot[slot]);
+}
+
+bvh::update_stats bvh::refit(int threads) {
+    update_stats stats;
+    if (dirty_leaves.empty()) return stats;
+
+    const int thread_count = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+    // Folhas movidas e seus ancestrais, agrupados por profundidade
+    std::vector<std::vector<uint32_t>> levels;
+    for (uint32_t leaf : dirty_leaves) {
+        for (uint32_t k = leaf; k != invalid && !nodes[k].dirty; k = nodes[k].parent) {
+            nodes[k].dirty = 1;
+            if (levels.size() <= nodes[k].depth) levels.resize(nodes[k].depth + 1);
+            levels[nodes[k].depth].push_back(k);
+        }
+    }
+    dirty_leaves.clear();
+    for (auto& level : levels) std::sort(level.begin(), level.end()); // Acesso sequencial aos nós
+
+    // De baixo para cima: um nível só lê caixas do nível de baixo, já atualizado
+    for (size_t d = levels.size(); d-- > 0;) {
+        const std::vector<uint32_t>& level = levels[d];
+        parallel_for(level.size(), thread_count, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                node& n = nodes[level[k]];
+                if (n.is_leaf()) {
+                    n.box = aabb();
+                    for (uint32_t s = n.prim_begin; s < n.prim_begin + n.prim_count; ++s)
+                        n.box.expand(refs[s].box);
+                } else {
+                    n.box = surrounding_box(nodes[n.child].box, nodes[n.child + 1].box);
+                }
+                n.cost = node_cost(n);
+            }
+        });
+        stats.refit_nodes += level.size();
+    }
+
+    // De cima para baixo: reconstrói as subárvores mais altas cuja qualidade degradou
+    for (const std::vector<uint32_t>& level : levels) {
+        for (uint32_t index : level) {
+            node& n = nodes[index];
+            if (n.dirty != 1) continue; // Descartado por uma reconstrução acima
+            n.dirty = 0;
+            if (n.is_leaf() || n.cost <= rebuild_threshold * n.build_cost) continue;
+
+            // Os descendentes antigos viram lixo; marcados para serem pulados
+            std::vector<uint32_t> stack = {n.child, n.child + 1};
+            while (!stack.empty()) {
+                node& old = nodes[stack.back()];
+                stack.pop_back();
+                old.dirty = 2;
+                garbage_nodes++;
+                if (!old.is_leaf()) {
+                    stack.push_back(old.child);
+                    stack.push_back(old.child + 1);
+                }
+            }
+
+            stats.rebuilt_subtrees++;
+            stats.rebuilt_primitives += n.prim_count;
+            build_node(index, n.prim_begin, n.prim_count, n.parent, n.depth);
+
+            // A caixa não muda, mas o custo dos ancestrais sim
+            for (uint32_t k = nodes[index].parent; k != invalid; k = nodes[k].parent)
+                nodes[k].cost = node_cost(nodes[k]);
+        }
+    }
+
+    // Muito lixo acumulado: reconstrói tudo e compacta o vetor de nós
+    if (garbage_nodes > nodes.size() / 2) {
+        rebuild();
+        stats.rebuilt_subtrees++;
+        stats.rebuilt_primitives = refs.size();
+    }
+
+    return stats;
+}
+
+bool bvh::hit(const ray& r, double t_min, double t_max, hit_record& rec) const {
+    bool hit_anything = false;
+    double closest_so_far = t_max;
+
+    for (const auto& object : unbounded) {
+        if (object->hit(r, t_min, closest_so_far, rec)) {
+            hit_anything = true;
+            closest_so_far = rec.t;
+        }
+    }
+    if (nodes.empty()) return hit_anything;
+
+    return traverse(0, r, t_min, closest_so_far, rec) || hit_anything;
+}
+
+bool bvh::traverse(uint32_t root, const ray& r, double t_min, double t_max, hit_record& rec) const {
+    bool hit_anything = false;
+    double closest_so_far = t_max;
+
+    const vec3& d = r.direction();
+    const vec3 inv_dir(1 / d.x(), 1 / d.y(), 1 / d.z());
+
+    uint32_t stack[stack_size];
+    int top = 0;
+    stack[top++] = root;
+
+    while (top > 0) {
+        const node& n = nodes[stack[--top]];
+        double t_enter;
+        if (!n.box.hit(r, inv_dir, t_min, closest_so_far, t_enter)) continue;
+
+        if (n.is_leaf()) {
+            for (uint32_t s = n.prim_begin; s < n.prim_begin + n.prim_count; ++s) {
+                if (refs[s].object->hit(r, t_min, closest_so_far, rec)) {
+                    hit_anything = true;
+                    closest_so_far = rec.t;
+                }
+            }
+        } else {
+            // O filho do lado de onde o raio vem é visitado primeiro
+            const uint32_t near = n.child + (d[n.axis] < 0);
+            const uint32_t far = n.child + (d[n.axis] >= 0);
+            stack[top++] = far;
+            stack[top++] = near;
+        }
+    }
+
+    return hit_anything;
+}
+
+uint64_t bvh::hit_packet(const ray_packet& packet, double t_min, double t_max, hit_record* rec) const {
+    uint64_t hit_mask = 0;
+    double closest[ray_packet::max_size];
+    alignas(32) float t_far[ray_packet::max_size];
+
+    for (int k = 0; k < ray_packet::max_size; ++k) {
+        closest[k] = t_max;
+        if (k < packet.count) {
+            for (const auto& object : unbounded) {
+                if (object->hit(packet.rays[k], t_min, closest[k], rec[k])) {
+                    hit_mask |= uint64_t(1) << k;
+                    closest[k] = rec[k].t;
+                }
+            }
+        }
+        t_far[k] = static_cast<float>(closest[k]);
+    }
+    if (nodes.empty()) return hit_mask;
+
+    const float t_near = static_cast<float>(t_min) * (1 - packet_padding);
+
+    struct entry {
+        uint32_t node;
+        uint64_t active; // Raios que atingiram a caixa do pai
+    };
+    entry stack[stack_size];
+    int top = 0;
+    stack[top++] = {0, packet.all()};
+
+    while (top > 0) {
+        const entry e = stack[--top];
+        const node& n = nodes[e.node];
+        if (packet.culls(n.box)) continue;
+
+        const uint64_t active = packet_box_hits(n.box, packet, e.active, t_near, t_far);
+        if (!active) continue;
+
+        if (__builtin_popcountll(active) < divergence_threshold) {
+            // Pacote divergiu: cada raio termina a subárvore sozinho
+            for (uint64_t m = active; m; m &= m - 1) {
+                int k = __builtin_ctzll(m);
+                if (traverse(e.node, packet.rays[k], t_min, closest[k], rec[k])) {
+                    hit_mask |= uint64_t(1) << k;
+                    closest[k] = rec[k].t;
+                    t_far[k] = static_cast<float>(closest[k]);
+                }
+            }
+            continue;
+        }
+
+        if (n.is_leaf()) {
+            for (uint64_t m = active; m; m &= m - 1) {
+                int k = __builtin_ctzll(m);
+                for (uint32_t s = n.prim_begin; s < n.prim_begin + n.prim_count; ++s) {
+                    if (refs[s].object->hit(packet.rays[k], t_min, closest[k], rec[k])) {
+                        hit_mask |= uint64_t(1) << k;
+                        closest[k] = rec[k].t;
+                        t_far[k] = static_cast<float>(closest[k]);
+                    }
+                }
+            }
+        } else {
+            // Ordem de visita pela direção do primeiro raio ativo
+            const vec3& d = packet.rays[__builtin_ctzll(active)].direction();
+            const uint32_t near = n.child + (d[n.axis] < 0);
+            const uint32_t far = n.child + (d[n.axis] >= 0);
+            stack[top++] = {far, active};
+            stack[top++] = {near, active};
+        }
+    }
+
+    return hit_mask;
+}
+
+bool bvh::hit_any(const ray& r, double t_min, double t_max) const {
+    for (const auto& object : unbounded)
+        if (object->hit_any(r, t_min, t_max)) return true;
+    if (nodes.empty()) return false;
+
+    const vec3& d = r.direction();
+    const vec3 inv_dir(1 / d.x(), 1 / d.y(), 1 / d.z());
+
+    uint32_t stack[stack_size];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const node& n = nodes[stack[--top]];
+        double t_enter;
+        if (!n.box.hit(r, inv_dir, t_min, t_max, t_enter)) continue;
+
+        if (n.is_leaf()) {
+            for (uint32_t s = n.prim_begin; s < n.prim_begin + n.prim_count; ++s)
+                if (refs[s].object->hit_any(r, t_min, t_max)) return true;
+        } else {
+            stack[top++] = n.child;
+            stack[top++] = n.child + 1;
+        }
+    }
+
+    return false;
+}
+
+bool bvh::bounding_box(aabb& output_box) const {
+    if (!unbounded.empty() || nodes.empty()) return false;
+    output_box = nodes[0].box;
+    return true;
+}
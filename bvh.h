@@ -0,0 +1,132 @@
+#pragma once
+
+#include "hittable.h"
+#include "aabb.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using std::shared_ptr;
+
+/**
+ * @class bvh
+ * @brief Hierarquia de volumes envolventes (BVH) binária com atualização incremental
+ *
+ * Construída por SAH (surface area heuristic) com binning. Os nós ficam num
+ * vetor contíguo; filhos de um nó interno ocupam posições consecutivas.
+ *
+ * Para cenas animadas, não é preciso reconstruir tudo a cada quadro:
+ *   1. altere o objeto (ex.: `sphere::center`);
+ *   2. chame `mark_moved(i)`, com o índice do objeto no vetor original;
+ *   3. chame `refit()` antes do próximo render.
+ *
+ * `refit` recalcula, de baixo para cima e em paralelo por nível, as caixas dos
+ * nós afetados. Se o custo SAH de uma subárvore piorar mais que
+ * `rebuild_threshold` vezes em relação ao da construção, só essa subárvore é
+ * reconstruída. Nenhum dos dois pode rodar durante um render.
+ *
+ * Objetos sem caixa (`bounding_box` retorna false) ficam fora da árvore e
+ * são testados à parte.
+ */
+class bvh : public hittable {
+public:
+    /// Resultado de um `refit`
+    struct update_stats {
+        size_t refit_nodes = 0;        // Nós com caixa recalculada
+        size_t rebuilt_subtrees = 0;   // Subárvores reconstruídas por SAH
+        size_t rebuilt_primitives = 0; // Objetos nas subárvores reconstruídas
+    };
+
+    /**
+     * @param objects Objetos da cena (ex.: `hittable_list::objects`)
+     * @param max_leaf_size Máximo de objetos por folha (1 a 16)
+     */
+    bvh(const std::vector<shared_ptr<hittable>>& objects, int max_leaf_size = 4);
+
+    virtual bool hit(const ray& r, double t_min, double t_max, hit_record& rec) const override;
+
+    virtual bool hit_any(const ray& r, double t_min, double t_max) const override;
+
+    /**
+     * @brief Percorre a árvore com o pacote inteiro
+     *
+     * Em cada nó, o frustum do pacote descarta a caixa de uma vez; se não, os
+     * raios ainda ativos são testados contra ela (8 por vez com AVX2). Quando
+     * sobram poucos raios ativos num nó, o pacote divergiu: cada um termina
+     * a subárvore sozinho, pela travessia normal.
+     */
+    virtual uint64_t hit_packet(const ray_packet& packet, double t_min, double t_max,
+                                hit_record* rec) const override;
+
+    virtual bool bounding_box(aabb& output_box) const override;
+
+    /**
+     * @brief Avisa que o objeto `object_index` mudou de lugar ou de tamanho
+     */
+    void mark_moved(size_t object_index);
+
+    /**
+     * @brief Atualiza a árvore após `mark_moved`
+     *
+     * @param threads Threads para o refit (0 = uma por núcleo)
+     */
+    update_stats refit(int threads = 0);
+
+    /// Reconstrói a árvore inteira
+    void rebuild();
+
+    /// Número de nós alocados (inclui nós descartados por reconstruções parciais)
+    size_t node_count() const { return nodes.size(); }
+
+    /// Memória ocupada pelos nós
+    size_t memory_bytes() const { return nodes.size() * sizeof(node); }
+
+    /// Piora máxima do custo SAH de uma subárvore antes de reconstruí-la
+    double rebuild_threshold = 1.5;
+
+private:
+    friend class wide_bvh;
+
+    static constexpr uint32_t invalid = 0xffffffffu;
+
+    struct node {
+        aabb box;
+        uint32_t child;      // Nó interno: filho esquerdo (direito = child + 1). Folha: invalid
+        uint32_t parent;
+        uint32_t prim_begin; // Objetos da subárvore: refs[prim_begin, prim_begin + prim_count)
+        uint32_t prim_count;
+        float build_cost;    // Custo SAH da subárvore quando foi construída
+        float cost;          // Custo SAH atual
+        uint16_t depth;
+        uint8_t axis;        // Eixo da divisão (ordem de visita dos filhos)
+        uint8_t dirty;
+
+        bool is_leaf() const { return child == invalid; }
+    };
+
+    // Referência a um objeto dentro da árvore
+    struct prim_ref {
+        aabb box;
+        const hittable* object;
+        uint32_t index; // Posição no vetor original
+    };
+
+    float build_node(uint32_t index, uint32_t begin, uint32_t count, uint32_t parent, uint16_t depth);
+
+    /// Travessia de um raio a partir do nó `root`, sem os objetos sem caixa
+    bool traverse(uint32_t root, const ray& r, double t_min, double t_max, hit_record& rec) const;
+    float node_cost(const node& n) const;
+
+private:
+    std::vector<shared_ptr<hittable>> objects; // Ordem original (mantém os objetos vivos)
+    std::vector<shared_ptr<hittable>> unbounded;
+    std::vector<node> nodes;
+    std::vector<prim_ref> refs;                // Ordem das folhas
+
+    std::vector<uint32_t> slot_of_object;      // Índice original -> posição em refs
+    std::vector<uint32_t> leaf_of_slot;        // Posição em refs -> folha
+    std::vector<uint32_t> dirty_leaves;
+
+    int max_leaf_size;
+    size_t garbage_nodes = 0;                  // Nós órfãos de reconstruções parciais
+};
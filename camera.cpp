@@ -1,4 +1,5 @@
 #include "camera.h"
+#include <algorithm>
 
 // Construtor
 camera::camera() {
@@ -26,8 +27,44 @@ void camera::move_right(double speed) {
     recalculate();
 }
 
-ray camera::get_ray(double u, double v) const {
-    return ray(origin, lower_left_corner + u*horizontal + v*vertical - origin);
+bool camera::move(char key, double speed) {
+    switch (key) {
+        case 'w': move_forward(speed); return true;
+        case 's': move_backward(speed); return true;
+        case 'a': move_left(speed); return true;
+        case 'd': move_right(speed); return true;
+    }
+    return false;
+}
+
+void camera::set_position(const point3& p) {
+    origin = p;
+    recalculate();
+}
+
+ray camera::get_ray(double u, double v, double spread) const {
+    return ray(origin, lower_left_corner + u*horizontal + v*vertical - origin, 0, spread);
+}
+
+double camera::pixel_spread(int image_width) const {
+    return horizontal.length() / std::max(1, image_width - 1) / focal_length;
+}
+
+bool camera::project(const point3& p, double& u, double& v) const {
+    // Direção do centro da tela (perpendicular a horizontal e vertical)
+    vec3 forward = lower_left_corner + horizontal/2 + vertical/2 - origin;
+    vec3 d = p - origin;
+
+    auto along = dot(d, forward);
+    if (along <= 0) return false; // Atrás da câmera
+
+    // Interseção da reta origem -> p com o plano da imagem
+    point3 q = origin + (forward.length_squared() / along) * d;
+    vec3 offset = q - lower_left_corner;
+
+    u = dot(offset, horizontal) / horizontal.length_squared();
+    v = dot(offset, vertical) / vertical.length_squared();
+    return u >= 0 && u <= 1 && v >= 0 && v <= 1;
 }
 
 void camera::reset_view() {
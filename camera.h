@@ -15,10 +15,38 @@ class camera {
         void move_left(double speed);
         void move_right(double speed);
 
+        /**
+         * @brief Move a câmera pela tecla de movimento (`w`, `a`, `s`, `d`).
+         * @return `false` se a tecla não for de movimento.
+         */
+        bool move(char key, double speed = 0.5);
+
         /**
          * @brief Gera um raio a partir da câmera para as coordenadas (u, v).
+         * @param spread Abertura do cone do raio (ex.: `pixel_spread`); 0 = sem pegada
+         */
+        ray get_ray(double u, double v, double spread = 0) const;
+
+        /**
+         * @brief Ângulo que um pixel subtende no centro da imagem, para `image_width` pixels.
+         */
+        double pixel_spread(int image_width) const;
+
+        /**
+         * @brief Projeta um ponto do mundo nas coordenadas (u, v) da imagem.
+         * @return `false` se o ponto estiver atrás da câmera ou fora da tela.
+         */
+        bool project(const point3& p, double& u, double& v) const;
+
+        /**
+         * @brief Posição atual da câmera.
+         */
+        point3 position() const { return origin; }
+
+        /**
+         * @brief Move a câmera para a posição dada (ex.: ao retomar um checkpoint).
          */
-        ray get_ray(double u, double v) const;
+        void set_position(const point3& p);
 
     private:
         point3 origin;
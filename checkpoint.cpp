@@ -0,0 +1,188 @@
+#include "checkpoint.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char checkpoint_magic[8] = {'R', 'T', 'C', 'K', 'P', 'T', '1', '\0'};
+const uint32_t checkpoint_version = 2;
+
+// Cabeçalho do arquivo (64 bytes)
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t samples_per_pixel;
+    int32_t max_depth;
+    uint16_t tile_size;   // Layout em tiles do acúmulo (ver AccumulationBuffer)
+    uint16_t tile_order;
+    uint64_t seed;
+    double camera[3];
+};
+static_assert(sizeof(CheckpointHeader) == 64, "cabeçalho do checkpoint deve ter 64 bytes");
+
+// Tamanho total do arquivo para uma imagem com `pixels` pixels
+size_t checkpoint_size(size_t pixels) {
+    return sizeof(CheckpointHeader) + pixels * (3 * sizeof(float) + sizeof(uint32_t) + sizeof(float));
+}
+
+} // namespace
+
+CheckpointWriter::CheckpointWriter(const std::string& path, int width, int height)
+    : path(path), staging(width, height), current(width, height)
+{
+    worker = std::thread(&CheckpointWriter::run, this);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void CheckpointWriter::submit(const AccumulationBuffer& accumulation, const CheckpointInfo& info) {
+    {
+        // Só uma cópia em memória: a thread de I/O troca de buffer sem segurar o lock
+        std::lock_guard<std::mutex> lock(mutex);
+        staging = accumulation;
+        staging_info = info;
+        pending = true;
+    }
+    wake.notify_one();
+}
+
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return !pending && !writing; });
+}
+
+void CheckpointWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return pending || stop; });
+        if (!pending && stop) break;
+
+        std::swap(staging, current);
+        current_info = staging_info;
+        pending = false;
+        writing = true;
+
+        lock.unlock();
+        write(current, current_info);
+        lock.lock();
+
+        writing = false;
+        done.notify_all();
+    }
+}
+
+void CheckpointWriter::write(const AccumulationBuffer& accumulation, const CheckpointInfo& info) {
+    CheckpointHeader header = {};
+    std::memcpy(header.magic, checkpoint_magic, sizeof(header.magic));
+    header.version = checkpoint_version;
+    header.width = accumulation.width;
+    header.height = accumulation.height;
+    header.samples_per_pixel = info.samples_per_pixel;
+    header.max_depth = info.max_depth;
+    header.tile_size = static_cast<uint16_t>(accumulation.tile_size);
+    header.tile_order = static_cast<uint16_t>(accumulation.order);
+    header.seed = info.seed;
+    for (int k = 0; k < 3; ++k) header.camera[k] = info.camera_position[k];
+
+    // Escreve num arquivo temporário e renomeia: o checkpoint antigo só é
+    // substituído quando o novo está completo
+    std::string tmp_path = path + ".tmp";
+    std::FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Erro ao gravar checkpoint: " << tmp_path << std::endl;
+        return;
+    }
+
+    const size_t pixels = accumulation.count.size();
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+           && std::fwrite(accumulation.r.data(), sizeof(float), pixels, file) == pixels
+           && std::fwrite(accumulation.g.data(), sizeof(float), pixels, file) == pixels
+           && std::fwrite(accumulation.b.data(), sizeof(float), pixels, file) == pixels
+           && std::fwrite(accumulation.count.data(), sizeof(uint32_t), pixels, file) == pixels
+           && std::fwrite(accumulation.depth.data(), sizeof(float), pixels, file) == pixels;
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::cerr << "Erro ao gravar checkpoint: " << path << std::endl;
+        std::remove(tmp_path.c_str());
+    }
+}
+
+bool load_checkpoint(const std::string& path, AccumulationBuffer& accumulation, CheckpointInfo& info) {
+    const size_t pixels = accumulation.count.size();
+    const size_t expected = checkpoint_size(pixels);
+
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != expected) {
+        close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, expected, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    const char* data = static_cast<const char*>(mapped);
+#else
+    std::vector<char> contents(expected);
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    bool complete = std::fread(contents.data(), 1, expected, file) == expected && std::fgetc(file) == EOF;
+    std::fclose(file);
+    if (!complete) return false;
+
+    const char* data = contents.data();
+#endif
+
+    CheckpointHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    bool valid = std::memcmp(header.magic, checkpoint_magic, sizeof(header.magic)) == 0
+              && header.version == checkpoint_version
+              && header.width == accumulation.width
+              && header.height == accumulation.height
+              && header.tile_size == accumulation.tile_size
+              && header.tile_order == static_cast<uint16_t>(accumulation.order);
+
+    if (valid) {
+        info.samples_per_pixel = header.samples_per_pixel;
+        info.max_depth = header.max_depth;
+        info.seed = header.seed;
+        info.camera_position = point3(header.camera[0], header.camera[1], header.camera[2]);
+
+        // Os planos vêm na mesma ordem em que foram gravados
+        const char* plane = data + sizeof(CheckpointHeader);
+        std::memcpy(accumulation.r.data(), plane, pixels * sizeof(float));     plane += pixels * sizeof(float);
+        std::memcpy(accumulation.g.data(), plane, pixels * sizeof(float));     plane += pixels * sizeof(float);
+        std::memcpy(accumulation.b.data(), plane, pixels * sizeof(float));     plane += pixels * sizeof(float);
+        std::memcpy(accumulation.count.data(), plane, pixels * sizeof(uint32_t)); plane += pixels * sizeof(uint32_t);
+        std::memcpy(accumulation.depth.data(), plane, pixels * sizeof(float));
+    }
+
+#ifndef _WIN32
+    munmap(mapped, expected);
+#endif
+    return valid;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "accumulation.h"
+#include "vec3.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @struct CheckpointInfo
+ * @brief Parâmetros do render guardados junto com o acúmulo
+ *
+ * Um checkpoint só é retomado se estes valores forem compatíveis com o render atual.
+ */
+struct CheckpointInfo {
+    int samples_per_pixel = 0;
+    int max_depth = 0;
+    uint64_t seed = 0;         // Semente global do gerador aleatório
+    point3 camera_position;
+};
+
+/**
+ * @class CheckpointWriter
+ * @brief Grava checkpoints do acúmulo numa thread de I/O separada
+ *
+ * `submit` só copia o acúmulo para uma área de espera e retorna; a escrita
+ * em disco acontece na thread de I/O. O arquivo é escrito num `.tmp` e
+ * renomeado no fim, então um processo morto no meio da escrita nunca
+ * deixa um checkpoint corrompido.
+ *
+ * Formato: cabeçalho de 64 bytes seguido dos planos `r`, `g`, `b` (float),
+ * `count` (uint32) e `depth` (float), todos alinhados a 4 bytes para
+ * poderem ser lidos direto de um `mmap`. Os planos ficam no layout em tiles
+ * do `AccumulationBuffer`, e só são retomados com o mesmo tamanho e ordem de tile.
+ */
+class CheckpointWriter {
+public:
+    CheckpointWriter(const std::string& path, int width, int height);
+
+    /// Grava o que estiver pendente e encerra a thread de I/O
+    ~CheckpointWriter();
+
+    /**
+     * @brief Agenda a gravação de um checkpoint
+     *
+     * Se a gravação anterior ainda não começou, ela é substituída por esta.
+     */
+    void submit(const AccumulationBuffer& accumulation, const CheckpointInfo& info);
+
+    /// Bloqueia até a gravação pendente terminar
+    void flush();
+
+private:
+    void run();
+    void write(const AccumulationBuffer& accumulation, const CheckpointInfo& info);
+
+private:
+    std::string path;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool pending = false;  // Há um checkpoint na área de espera
+    bool writing = false;  // A thread de I/O está gravando
+    bool stop = false;
+
+    AccumulationBuffer staging;       // Preenchido pelo render
+    CheckpointInfo staging_info;
+    AccumulationBuffer current;       // Sendo gravado pela thread de I/O
+    CheckpointInfo current_info;
+
+    std::thread worker;
+};
+
+/**
+ * @brief Carrega um checkpoint mapeando o arquivo com `mmap`
+ *
+ * @param path Arquivo de checkpoint
+ * @param accumulation Recebe o acúmulo; precisa ter as dimensões e o layout do arquivo
+ * @param info Recebe os parâmetros gravados
+ * @return false se o arquivo não existir, estiver incompleto ou tiver outras dimensões
+ */
+bool load_checkpoint(const std::string& path, AccumulationBuffer& accumulation, CheckpointInfo& info);
@@ -0,0 +1,281 @@
+// Benchmark de convergência em tempo igual: compara integradores e modos de
+// traçado pela qualidade que entregam por segundo, não pela velocidade dos raios.
+//
+//   rtconverge [--scene default|lights|diffuse] [--budget <s>] [--width <px>]
+//              [--reference-spp <n>] [--reference <arquivo.pfm>] [--csv <arquivo>]
+//              [--configs recursive,path,reorder,packets,irradiance-cache]
+//
+// A referência é renderizada uma vez com o PathIntegrator em `reference-spp`
+// amostras (outra semente) e guardada em PFM; as execuções seguintes a
+// reaproveitam. Cada configuração é renderizada do zero com 1, 2, 3, 4, 6,
+// 8, 11, ... amostras por pixel até passar do orçamento, medindo o tempo de
+// parede de cada render. O CSV tem uma linha por render (tempo, amostras,
+// RMSE e relMSE contra a referência); no fim, o erro de cada configuração
+// no tempo do orçamento é interpolado em log-log. O erro medido inclui o
+// ruído da própria referência (~1/reference-spp do de 1 spp).
+
+#include "renderer.h"
+#include "animation.h"
+#include "bvh.h"
+#include "hittable_list.h"
+#include "scenes.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Sementes diferentes: o ruído da referência não se correlaciona com o das execuções
+const uint64_t reference_seed = 0x9e3779b97f4a7c15ull;
+const uint64_t run_seed = 0;
+
+/// Imagem linear RGB em float, linha 0 embaixo (como `j` e como o PFM)
+struct LinearImage {
+    int width = 0, height = 0;
+    std::vector<float> rgb;
+};
+
+LinearImage average(const AccumulationBuffer& image) {
+    LinearImage out{image.width, image.height, std::vector<float>(3 * size_t(image.width) * image.height)};
+    for (int j = 0; j < image.height; ++j) {
+        for (int i = 0; i < image.width; ++i) {
+            int idx = image.index(i, j);
+            float scale = image.count[idx] ? 1.0f / image.count[idx] : 0.0f;
+            float* p = &out.rgb[3 * (size_t(j) * image.width + i)];
+            p[0] = image.r[idx] * scale;
+            p[1] = image.g[idx] * scale;
+            p[2] = image.b[idx] * scale;
+        }
+    }
+    return out;
+}
+
+/// Lê o PFM gravado por `save_frame` (little-endian); false se não existir ou for inválido
+bool load_pfm(const std::string& path, LinearImage& image) {
+    std::ifstream in(path, std::ios::binary);
+    std::string magic;
+    double scale = 0;
+    if (!(in >> magic >> image.width >> image.height >> scale) || magic != "PF" || scale >= 0
+        || image.width <= 0 || image.height <= 0)
+        return false;
+    in.get(); // Um espaço em branco separa o cabeçalho dos dados
+    image.rgb.resize(3 * size_t(image.width) * image.height);
+    return bool(in.read(reinterpret_cast<char*>(image.rgb.data()), image.rgb.size() * sizeof(float)));
+}
+
+struct Error {
+    double rmse = 0;
+    double relmse = 0; // Média de (x - ref)² / (ref² + 0.01), por canal
+};
+
+Error compare(const LinearImage& image, const LinearImage& reference) {
+    double squared = 0, relative = 0;
+    for (size_t k = 0; k < image.rgb.size(); ++k) {
+        double ref = reference.rgb[k];
+        double d = image.rgb[k] - ref;
+        squared += d * d;
+        relative += d * d / (ref * ref + 0.01);
+    }
+    const double n = double(image.rgb.size());
+    return {std::sqrt(squared / n), relative / n};
+}
+
+/// Uma configuração comparada: integrador + modo de traçado
+struct Config {
+    std::string name;
+    bool reorder_rays = false;
+    bool primary_packets = false;
+};
+
+std::unique_ptr<Integrator> make_integrator(const std::string& name, int max_depth, const LightSampler& lights,
+                                            IrradianceCache& cache, bool sky) {
+    std::unique_ptr<Integrator> integrator;
+    if (name == "recursive")
+        integrator = std::make_unique<RecursiveIntegrator>(max_depth);
+    else if (name == "irradiance-cache")
+        integrator = std::make_unique<IrradianceCacheIntegrator>(max_depth, lights, cache);
+    else
+        integrator = std::make_unique<PathIntegrator>(max_depth, lights);
+    integrator->sky = sky;
+    return integrator;
+}
+
+struct Run {
+    double seconds;
+    Error error;
+};
+
+/// Renderiza do zero com `settings` e devolve o tempo de parede e a imagem média
+double timed_render(const hittable& scene, const camera& cam, const Integrator& integrator,
+                    const RenderSettings& settings, LinearImage& image) {
+    Renderer engine(settings);
+    auto start = std::chrono::steady_clock::now();
+    RenderJob job = engine.submit(scene, cam, integrator, settings);
+    job.wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    image = average(job.result().image);
+    return seconds;
+}
+
+/// Erro no tempo `t`, interpolado em log-log entre as execuções vizinhas (0 se não houver)
+double error_at(const std::vector<Run>& runs, double t, double Error::*metric) {
+    for (size_t k = 1; k < runs.size(); ++k) {
+        if (runs[k].seconds < t) continue;
+        const Run& a = runs[k - 1];
+        const Run& b = runs[k];
+        if (b.seconds <= a.seconds || a.error.*metric <= 0 || b.error.*metric <= 0) return b.error.*metric;
+        double s = std::log(t / a.seconds) / std::log(b.seconds / a.seconds);
+        return std::exp(std::log(a.error.*metric) + s * std::log(b.error.*metric / a.error.*metric));
+    }
+    return runs.empty() ? 0 : runs.back().error.*metric;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    RenderSettings settings;
+    settings.image_width = 320;
+    settings.max_depth = 50;
+    settings.temporal_reprojection = false;
+
+    std::string scene_name = "default";
+    std::string reference_path;
+    std::string csv_path = "convergencia.csv";
+    std::string config_list = "recursive,path,reorder,packets,irradiance-cache";
+    double budget = 10;
+    int reference_spp = 1024;
+    for (int k = 1; k < argc; ++k) {
+        std::string arg = argv[k];
+        if (arg == "--scene" && k + 1 < argc)
+            scene_name = argv[++k];
+        else if (arg == "--budget" && k + 1 < argc)
+            budget = std::stod(argv[++k]);
+        else if (arg == "--width" && k + 1 < argc)
+            settings.image_width = std::stoi(argv[++k]);
+        else if (arg == "--reference-spp" && k + 1 < argc)
+            reference_spp = std::stoi(argv[++k]);
+        else if (arg == "--reference" && k + 1 < argc)
+            reference_path = argv[++k];
+        else if (arg == "--csv" && k + 1 < argc)
+            csv_path = argv[++k];
+        else if (arg == "--configs" && k + 1 < argc)
+            config_list = argv[++k];
+        else {
+            std::fprintf(stderr, "Argumento desconhecido: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<Config> configs;
+    std::stringstream names(config_list);
+    for (std::string name; std::getline(names, name, ',');) {
+        if (name == "recursive" || name == "path" || name == "irradiance-cache")
+            configs.push_back({name});
+        else if (name == "reorder")
+            configs.push_back({name, true, false});
+        else if (name == "packets")
+            configs.push_back({name, false, true});
+        else {
+            std::fprintf(stderr, "Configuração desconhecida: %s\n", name.c_str());
+            return 1;
+        }
+    }
+
+    // Cena
+    hittable_list world;
+    LightSampler lights;
+    if (scene_name == "lights")
+        many_lights_scene(world, lights);
+    else if (scene_name == "diffuse")
+        diffuse_scene(world, lights);
+    else if (scene_name == "default")
+        default_scene(world);
+    else {
+        std::fprintf(stderr, "Cena desconhecida: %s\n", scene_name.c_str());
+        return 1;
+    }
+    const bool sky = scene_name == "default";
+    bvh scene(world.objects);
+    camera cam;
+    const int height = static_cast<int>(settings.image_width / settings.aspect_ratio);
+
+    // Referência: renderizada uma vez e reaproveitada
+    if (reference_path.empty())
+        reference_path = "referencia_" + scene_name + "_" + std::to_string(settings.image_width) + "x"
+                       + std::to_string(height) + "_" + std::to_string(reference_spp) + "spp.pfm";
+    LinearImage reference;
+    if (!load_pfm(reference_path, reference) || reference.width != settings.image_width || reference.height != height) {
+        std::printf("Renderizando a referência (%d spp) em %s...\n", reference_spp, reference_path.c_str());
+        std::fflush(stdout);
+        RenderSettings reference_settings = settings;
+        reference_settings.samples_per_pixel = reference_spp;
+        reference_settings.samples_per_pass = 16;
+        reference_settings.seed = reference_seed;
+        IrradianceCache unused;
+        auto integrator = make_integrator("path", settings.max_depth, lights, unused, sky);
+        Renderer engine(reference_settings);
+        RenderJob job = engine.submit(scene, cam, *integrator, reference_settings);
+        job.wait();
+        std::vector<uint32_t> pixels;
+        if (!save_frame(reference_path, job.result().image, settings.tonemap, pixels)
+            || !load_pfm(reference_path, reference))
+            return 1;
+    }
+
+    std::ofstream csv(csv_path);
+    if (!csv) {
+        std::fprintf(stderr, "Não foi possível gravar %s\n", csv_path.c_str());
+        return 1;
+    }
+    csv << "cena,config,spp,segundos,rmse,relmse\n";
+
+    // Amostras por pixel crescendo ~4/3 por execução
+    std::vector<int> spp_steps;
+    for (int spp = 1; spp <= 1 << 20; spp = spp < 3 ? spp + 1 : (spp * 4 + 2) / 3)
+        spp_steps.push_back(spp);
+
+    std::vector<std::vector<Run>> curves;
+    for (const Config& config : configs) {
+        std::vector<Run> runs;
+        for (int spp : spp_steps) {
+            RenderSettings run_settings = settings;
+            run_settings.samples_per_pixel = spp;
+            run_settings.samples_per_pass = std::min(spp, 16);
+            run_settings.seed = run_seed;
+            run_settings.reorder_rays = config.reorder_rays;
+            run_settings.primary_packets = config.primary_packets;
+
+            // Cache de irradiância vazio em cada execução: construí-lo faz parte do custo
+            IrradianceCache cache;
+            auto integrator = make_integrator(config.name, settings.max_depth, lights, cache, sky);
+            LinearImage image;
+            double seconds = timed_render(scene, cam, *integrator, run_settings, image);
+            Error error = compare(image, reference);
+            runs.push_back({seconds, error});
+
+            csv << scene_name << ',' << config.name << ',' << spp << ',' << seconds << ','
+                << error.rmse << ',' << error.relmse << '\n';
+            std::printf("%-17s %6d spp  %8.3f s  RMSE %.5f  relMSE %.6f\n",
+                        config.name.c_str(), spp, seconds, error.rmse, error.relmse);
+            std::fflush(stdout);
+            if (seconds >= budget) break;
+        }
+        curves.push_back(runs);
+    }
+
+    std::printf("\nErro em %.1f s (%s, %dx%d):\n", budget, scene_name.c_str(), settings.image_width, height);
+    const double base = configs.empty() ? 0 : error_at(curves[0], budget, &Error::relmse);
+    for (size_t c = 0; c < configs.size(); ++c) {
+        double relmse = error_at(curves[c], budget, &Error::relmse);
+        // Eficiência relativa: relMSE cai com 1/tempo, então a razão é o ganho em tempo
+        std::printf("  %-17s RMSE %.5f  relMSE %.6f  eficiência %.2fx\n", configs[c].name.c_str(),
+                    error_at(curves[c], budget, &Error::rmse), relmse, relmse > 0 ? base / relmse : 0.0);
+    }
+    std::printf("Curvas em %s\n", csv_path.c_str());
+    return 0;
+}
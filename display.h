@@ -0,0 +1,43 @@
+#pragma once
+
+#include "camera.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @class Display
+ * @brief Destino das imagens do render interativo e origem do input da câmera
+ *
+ * Implementado pela janela SDL local (`Window`) e pelo servidor que transmite
+ * os quadros para um visualizador remoto (`FrameStreamer`).
+ */
+class Display {
+public:
+    virtual ~Display() = default;
+
+    /**
+     * @brief Framebuffer: ARGB8888, `width x height`, linha 0 no topo
+     */
+    virtual uint32_t* pixel_buffer() = 0;
+
+    /**
+     * @brief Mostra (ou envia) o conteúdo atual do framebuffer
+     */
+    virtual void refresh() = 0;
+
+    /**
+     * @brief Troca o título mostrado com a imagem
+     */
+    virtual void set_title(const std::string& title) = 0;
+
+    /**
+     * @brief Processa o input pendente e movimenta a câmera
+     * @return `true` se a câmera se moveu, `false` caso contrário
+     */
+    virtual bool process_input(camera& cam) = 0;
+
+    /**
+     * @brief Indica se o render interativo deve terminar
+     */
+    virtual bool should_close() = 0;
+};
@@ -0,0 +1,201 @@
+#include "flat_scene.h"
+#include "sphere.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+// A divisão na mediana limita a profundidade a log2(n / max_leaf_size) + 1
+const int stack_size = 64;
+
+/**
+ * @brief Raiz mais próxima de uma esfera em [t_min, t_max]
+ * @param oc Origem do raio menos o centro da esfera
+ */
+inline bool sphere_root(double ocx, double ocy, double ocz, double dx, double dy, double dz, double a,
+                        double radius, double t_min, double t_max, double& root) {
+    double half_b = ocx*dx + ocy*dy + ocz*dz;
+    double c = ocx*ocx + ocy*ocy + ocz*ocz - radius*radius;
+
+    double discriminant = half_b*half_b - a*c;
+    if (discriminant < 0) return false;
+    double sqrtd = std::sqrt(discriminant);
+
+    root = (-half_b - sqrtd) / a;
+    if (root >= t_min && root <= t_max) return true;
+    root = (-half_b + sqrtd) / a;
+    return root >= t_min && root <= t_max;
+}
+
+} // namespace
+
+void flat_scene::build_tree() {
+    const size_t n = size();
+    nodes.clear();
+    if (n == 0) return;
+
+    const aligned_vector<double>* center[3] = {&center_x, &center_y, &center_z};
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+
+    struct task {
+        uint32_t node, begin, end;
+    };
+    std::vector<task> tasks{{0, 0, static_cast<uint32_t>(n)}};
+    nodes.reserve(2 * (n / max_leaf_size + 1));
+    nodes.push_back({});
+
+    while (!tasks.empty()) {
+        task t = tasks.back();
+        tasks.pop_back();
+
+        aabb box, centroids;
+        for (uint32_t k = t.begin; k < t.end; ++k) {
+            uint32_t s = order[k];
+            point3 c(center_x[s], center_y[s], center_z[s]);
+            vec3 extent(radius[s], radius[s], radius[s]);
+            box.expand(aabb(c - extent, c + extent));
+            centroids.expand(c);
+        }
+
+        if (t.end - t.begin <= static_cast<uint32_t>(max_leaf_size)) {
+            nodes[t.node] = {box, t.begin, static_cast<uint16_t>(t.end - t.begin), 0};
+            continue;
+        }
+
+        // Mediana dos centros no eixo mais longo
+        const int axis = centroids.longest_axis();
+        const uint32_t mid = t.begin + (t.end - t.begin) / 2;
+        const aligned_vector<double>& key = *center[axis];
+        std::nth_element(order.begin() + t.begin, order.begin() + mid, order.begin() + t.end,
+                         [&key](uint32_t a, uint32_t b) { return key[a] < key[b]; });
+
+        const uint32_t child = static_cast<uint32_t>(nodes.size());
+        nodes.push_back({});
+        nodes.push_back({});
+        nodes[t.node] = {box, child, 0, static_cast<uint8_t>(axis)};
+        tasks.push_back({child, t.begin, mid});
+        tasks.push_back({child + 1, mid, t.end});
+    }
+
+    // As folhas apontam para trechos de `order`: os vetores passam a seguir essa ordem
+    auto permute = [&order](auto& values) {
+        std::remove_reference_t<decltype(values)> sorted(values.size());
+        for (size_t k = 0; k < order.size(); ++k) sorted[k] = values[order[k]];
+        values.swap(sorted);
+    };
+    permute(center_x);
+    permute(center_y);
+    permute(center_z);
+    permute(radius);
+    permute(material_index);
+}
+
+bool flat_scene::hit(const ray& r, double t_min, double t_max, hit_record& rec) const {
+    if (nodes.empty()) return false;
+
+    const double ox = r.origin().x(), oy = r.origin().y(), oz = r.origin().z();
+    const vec3& d = r.direction();
+    const double dx = d.x(), dy = d.y(), dz = d.z();
+    const double a = dx*dx + dy*dy + dz*dz;
+    const vec3 inv_dir(1 / dx, 1 / dy, 1 / dz);
+
+    const size_t n = size();
+    size_t closest = n;
+    double closest_t = t_max;
+
+    uint32_t stack[stack_size];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const node& nd = nodes[stack[--top]];
+        double t_enter;
+        if (!nd.box.hit(r, inv_dir, t_min, closest_t, t_enter)) continue;
+
+        if (nd.count > 0) {
+            for (size_t k = nd.begin; k < nd.begin + nd.count; ++k) {
+                double root;
+                if (sphere_root(ox - center_x[k], oy - center_y[k], oz - center_z[k], dx, dy, dz, a,
+                                radius[k], t_min, closest_t, root)) {
+                    closest_t = root;
+                    closest = k;
+                }
+            }
+        } else {
+            // O filho do lado de onde o raio vem é visitado primeiro
+            stack[top++] = nd.begin + (d[nd.axis] >= 0);
+            stack[top++] = nd.begin + (d[nd.axis] < 0);
+        }
+    }
+
+    if (closest == n) return false;
+
+    // Só a esfera mais próxima preenche o registro
+    point3 center(center_x[closest], center_y[closest], center_z[closest]);
+    rec.t = closest_t;
+    rec.p = r.at(rec.t);
+    vec3 outward_normal = (rec.p - center) / radius[closest];
+
+    rec.front_face = dot(r.direction(), outward_normal) < 0;
+    rec.normal = rec.front_face ? outward_normal : -outward_normal;
+    rec.mat_ptr = materials[material_index[closest]];
+    rec.object = this;
+    rec.primitive = static_cast<uint32_t>(closest);
+
+    return true;
+}
+
+bool flat_scene::hit_any(const ray& r, double t_min, double t_max) const {
+    if (nodes.empty()) return false;
+
+    const double ox = r.origin().x(), oy = r.origin().y(), oz = r.origin().z();
+    const double dx = r.direction().x(), dy = r.direction().y(), dz = r.direction().z();
+    const double a = dx*dx + dy*dy + dz*dz;
+    const vec3 inv_dir(1 / dx, 1 / dy, 1 / dz);
+
+    uint32_t stack[stack_size];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const node& nd = nodes[stack[--top]];
+        double t_enter;
+        if (!nd.box.hit(r, inv_dir, t_min, t_max, t_enter)) continue;
+
+        if (nd.count > 0) {
+            for (size_t k = nd.begin; k < nd.begin + nd.count; ++k) {
+                double root;
+                if (sphere_root(ox - center_x[k], oy - center_y[k], oz - center_z[k], dx, dy, dz, a,
+                                radius[k], t_min, t_max, root))
+                    return true;
+            }
+        } else {
+            stack[top++] = nd.begin;
+            stack[top++] = nd.begin + 1;
+        }
+    }
+
+    return false;
+}
+
+double flat_scene::surface_uv(const hit_record& rec, double& u, double& v) const {
+    const uint32_t k = rec.primitive;
+    point3 center(center_x[k], center_y[k], center_z[k]);
+    sphere_uv((rec.p - center) / radius[k], u, v);
+    return pi * radius[k];
+}
+
+bool flat_scene::bounding_box(aabb& output_box) const {
+    if (nodes.empty()) return false;
+    output_box = nodes[0].box;
+    return true;
+}
+
+size_t flat_scene::memory_bytes() const {
+    return size() * (4 * sizeof(double) + sizeof(uint32_t))
+         + nodes.size() * sizeof(node)
+         + materials.size() * sizeof(const material*)
+         + material_arena.bytes_used();
+}
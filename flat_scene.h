@@ -0,0 +1,65 @@
+#pragma once
+
+#include "hittable.h"
+#include "arena.h"
+#include "aabb.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class flat_scene
+ * @brief Cena somente leitura com as esferas em vetores contíguos e alinhados
+ *
+ * Produzida por `scene_builder::freeze()`. Cada atributo das esferas fica num
+ * vetor próprio (centro x/y/z, raio, índice do material), alinhado a 64 bytes.
+ * `freeze` também monta uma BVH própria (divisão na mediana do eixo mais
+ * longo) e reordena os vetores na ordem das folhas: cada folha é um trecho
+ * contíguo dos vetores, percorrido em sequência pelo laço de interseção.
+ * Ponto, normal e material só são calculados uma vez, para a esfera mais próxima.
+ *
+ * Os materiais ficam na arena em que foram criados, que passa a pertencer à cena.
+ *
+ * As esferas daqui não são registradas individualmente num `LightSampler`:
+ * emissores que precisem de amostragem explícita devem ser objetos `sphere`.
+ */
+class flat_scene : public hittable {
+    public:
+        flat_scene() = default;
+
+        virtual bool hit(const ray& r, double t_min, double t_max, hit_record& rec) const override;
+
+        virtual bool hit_any(const ray& r, double t_min, double t_max) const override;
+
+        virtual bool bounding_box(aabb& output_box) const override;
+
+        /// Coordenadas esféricas da esfera `rec.primitive` (como `sphere::surface_uv`)
+        virtual double surface_uv(const hit_record& rec, double& u, double& v) const override;
+
+        /// Número de esferas
+        size_t size() const { return radius.size(); }
+
+        /// Memória ocupada pelas esferas e materiais, em bytes
+        size_t memory_bytes() const;
+
+    private:
+        friend class scene_builder;
+
+        struct node {
+            aabb box;
+            uint32_t begin;  // Folha: primeira esfera. Nó interno: filho esquerdo (direito = begin + 1)
+            uint16_t count;  // Esferas da folha (0 = nó interno)
+            uint8_t axis;    // Eixo da divisão (ordem de visita dos filhos)
+        };
+
+        /// Monta `nodes` e reordena as esferas na ordem das folhas
+        void build_tree();
+
+        static const int max_leaf_size = 4;
+
+        aligned_vector<double> center_x, center_y, center_z, radius;
+        aligned_vector<uint32_t> material_index;
+        std::vector<node> nodes;                // Raiz em nodes[0]
+
+        std::vector<const material*> materials; // Índice -> material na arena
+        Arena material_arena;                   // Dona dos materiais
+};
@@ -0,0 +1,85 @@
+#include "frame_budget.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const size_t decision_window = 4;   // Quadros considerados em cada decisão
+const size_t history_size = 1024;   // Quadros guardados para os percentis
+const double lower_band = 0.5;      // Sobe abaixo de 50% do alvo...
+const double upper_band = 1.1;      // ...e desce acima de 110%
+const int max_up_delay = 64;
+
+} // namespace
+
+FrameBudget::FrameBudget(double target_ms, int samples_per_pass, int max_depth)
+    : target_ms(target_ms)
+{
+    samples_per_pass = std::max(1, samples_per_pass);
+    max_depth = std::max(1, max_depth);
+
+    // A profundidade nunca cai: as amostras ficam no acúmulo da imagem final,
+    // e caminhos truncados a deixariam mais escura para sempre. Só a
+    // resolução interna e as amostras por passada mudam
+    for (int divisor = 8; divisor >= 1; divisor /= 2)
+        ladder.push_back({1, max_depth, divisor});
+
+    // Amostras por passada dobrando até o máximo
+    for (int spp = 2; spp < samples_per_pass; spp *= 2)
+        ladder.push_back({spp, max_depth, 1});
+    if (samples_per_pass > 1) ladder.push_back({samples_per_pass, max_depth, 1});
+
+    up_delay.assign(ladder.size(), static_cast<int>(decision_window));
+    level = 0; // Começa barato: o primeiro quadro não sabe quanto a cena custa
+    history.resize(history_size);
+}
+
+void FrameBudget::record(double frame_ms) {
+    history[frames % history_size] = frame_ms;
+    frames++;
+    frames_at_level++;
+
+    recent.push_back(frame_ms);
+    if (recent.size() > decision_window) recent.pop_front();
+    if (recent.size() < decision_window) return;
+
+    std::vector<double> window(recent.begin(), recent.end());
+    std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+    const double median = window[window.size() / 2];
+
+    if (median > upper_band * target_ms && level > 0) {
+        // Subiu e estourou logo em seguida: demora mais para tentar de novo
+        if (raised && frames_at_level <= static_cast<int>(2 * decision_window))
+            up_delay[level - 1] = std::min(2 * up_delay[level - 1], max_up_delay);
+
+        // Cada nível custa ~2x o anterior: estouros grandes descem vários de uma vez
+        int steps = std::max(1, static_cast<int>(std::log2(median / target_ms)));
+        change_level(std::max(0, level - steps));
+    } else if (median < lower_band * target_ms && level + 1 < static_cast<int>(ladder.size()) &&
+               frames_at_level >= up_delay[level]) {
+        change_level(level + 1);
+        raised = true;
+    }
+}
+
+void FrameBudget::exhausted() {
+    // Não conta como subida: estourar o alvo no nível de cima não o penaliza
+    if (level + 1 < static_cast<int>(ladder.size())) change_level(level + 1);
+}
+
+void FrameBudget::change_level(int new_level) {
+    level = new_level;
+    frames_at_level = 0;
+    raised = false;
+    recent.clear();
+}
+
+double FrameBudget::percentile(double p) const {
+    size_t n = std::min(frames, history_size);
+    if (n == 0) return 0;
+
+    std::vector<double> sorted(history.begin(), history.begin() + n);
+    size_t k = static_cast<size_t>(std::lround(std::clamp(p, 0.0, 100.0) / 100.0 * (n - 1)));
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+    return sorted[k];
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+/**
+ * @struct FrameQuality
+ * @brief Parâmetros de uma passada que determinam o seu custo
+ */
+struct FrameQuality {
+    int samples_per_pass;   // Amostras por pixel na passada
+    int max_depth;          // Profundidade máxima dos caminhos (o orçamento não a reduz)
+    int resolution_divisor; // 1 = todos os pixels; 2 = um pixel a cada bloco 2x2; ...
+};
+
+/**
+ * @class FrameBudget
+ * @brief Controla a qualidade das passadas para manter o tempo de quadro perto do alvo
+ *
+ * A qualidade anda numa escada de níveis. Descendo a partir do topo, caem
+ * primeiro as amostras por passada e depois a resolução interna; cada degrau
+ * custa mais ou menos metade do de cima. A profundidade fica sempre em
+ * `max_depth`: as amostras de todos os quadros vão para o mesmo acúmulo, e
+ * caminhos truncados deixariam a imagem convergida enviesada.
+ *
+ * A decisão usa a mediana dos últimos quadros, com histerese: desce um
+ * nível acima de 110% do alvo e só sobe abaixo de 50%. Um nível que
+ * acabou de subir e logo estourou o alvo espera o dobro de quadros antes
+ * de ser tentado outra vez, o que evita a oscilação entre dois níveis.
+ */
+class FrameBudget {
+public:
+    /**
+     * @param target_ms Tempo de quadro desejado
+     * @param samples_per_pass Amostras por passada no nível mais alto
+     * @param max_depth Profundidade dos caminhos em todos os níveis
+     */
+    FrameBudget(double target_ms, int samples_per_pass, int max_depth);
+
+    /// Qualidade a usar no próximo quadro
+    const FrameQuality& quality() const { return ladder[level]; }
+
+    /// Registra a duração de um quadro e ajusta a qualidade
+    void record(double frame_ms);
+
+    /// O nível atual não tem mais amostras a fazer (resolução reduzida já completa): sobe um nível
+    void exhausted();
+
+    /// Percentil `p` (0 a 100) dos últimos quadros registrados
+    double percentile(double p) const;
+
+    /// Quadros registrados desde a criação
+    size_t frame_count() const { return frames; }
+
+    double target() const { return target_ms; }
+
+private:
+    void change_level(int new_level);
+
+private:
+    double target_ms;
+    std::vector<FrameQuality> ladder;
+    std::vector<int> up_delay;        // Quadros de espera antes de subir de cada nível
+    int level;
+    int frames_at_level = 0;
+    bool raised = false;              // O nível atual foi alcançado subindo
+
+    std::deque<double> recent;        // Janela da decisão
+    std::vector<double> history;      // Anel para os percentis
+    size_t frames = 0;
+};
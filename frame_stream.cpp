@@ -0,0 +1,313 @@
+#include "frame_stream.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// Corridas mais curtas que isto saem mais baratas como literais
+const size_t min_run = 3;
+const size_t max_run = 130;
+const size_t max_literal = 128;
+
+void packbits(const uint8_t* in, size_t n, std::vector<uint8_t>& out) {
+    size_t i = 0;
+    while (i < n) {
+        size_t run = 1;
+        while (i + run < n && run < max_run && in[i + run] == in[i]) ++run;
+        if (run >= min_run) {
+            out.push_back(static_cast<uint8_t>(run + 125));
+            out.push_back(in[i]);
+            i += run;
+            continue;
+        }
+
+        // Literais até o começo da próxima corrida
+        size_t start = i;
+        while (i < n && i - start < max_literal) {
+            if (i + 2 < n && in[i] == in[i + 1] && in[i] == in[i + 2]) break;
+            ++i;
+        }
+        out.push_back(static_cast<uint8_t>(i - start - 1));
+        out.insert(out.end(), in + start, in + i);
+    }
+}
+
+/// Envia tudo ou falha (conexão caiu)
+bool send_all(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/// Esvazia o pipe de despertar (não bloqueante): cada `refresh` deixa um byte nele
+void drain(int fd) {
+    char buffer[64];
+    while (read(fd, buffer, sizeof(buffer)) > 0) {}
+}
+
+template <typename T>
+void append(std::vector<uint8_t>& out, const T& value) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+} // namespace
+
+void encode_tile(const uint32_t* pixels, int stride, int width, int height, std::vector<uint8_t>& out) {
+    out.clear();
+    std::vector<uint8_t> plane(static_cast<size_t>(width) * height);
+
+    for (int shift = 16; shift >= 0; shift -= 8) {
+        for (int y = 0; y < height; ++y) {
+            const uint32_t* row = pixels + static_cast<size_t>(y) * stride;
+            uint8_t previous = y > 0 ? static_cast<uint8_t>(row[-stride] >> shift) : 0;
+            for (int x = 0; x < width; ++x) {
+                uint8_t value = static_cast<uint8_t>(row[x] >> shift);
+                plane[static_cast<size_t>(y) * width + x] = static_cast<uint8_t>(value - previous);
+                previous = value;
+            }
+        }
+        packbits(plane.data(), plane.size(), out);
+    }
+}
+
+bool decode_tile(const uint8_t* data, size_t size, uint32_t* pixels, int stride, int width, int height) {
+    const size_t count = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> plane(count);
+    const uint8_t* end = data + size;
+
+    for (int y = 0; y < height; ++y)
+        std::fill(pixels + static_cast<size_t>(y) * stride, pixels + static_cast<size_t>(y) * stride + width, 0xff000000u);
+
+    for (int shift = 16; shift >= 0; shift -= 8) {
+        size_t filled = 0;
+        while (filled < count) {
+            if (data >= end) return false;
+            uint8_t control = *data++;
+            if (control >= 128) {
+                size_t run = control - 125u;
+                if (data >= end || filled + run > count) return false;
+                std::fill(plane.begin() + filled, plane.begin() + filled + run, *data++);
+                filled += run;
+            } else {
+                size_t literal = control + 1u;
+                if (static_cast<size_t>(end - data) < literal || filled + literal > count) return false;
+                std::memcpy(plane.data() + filled, data, literal);
+                data += literal;
+                filled += literal;
+            }
+        }
+
+        // Desfaz as diferenças na mesma ordem em que foram feitas
+        for (int y = 0; y < height; ++y) {
+            uint32_t* row = pixels + static_cast<size_t>(y) * stride;
+            uint8_t previous = y > 0 ? static_cast<uint8_t>(row[-stride] >> shift) : 0;
+            for (int x = 0; x < width; ++x) {
+                uint8_t value = static_cast<uint8_t>(previous + plane[static_cast<size_t>(y) * width + x]);
+                row[x] |= uint32_t(value) << shift;
+                previous = value;
+            }
+        }
+    }
+    return data == end;
+}
+
+FrameStreamer::FrameStreamer(int port, int width, int height, int tile_size)
+    : width(width), height(height), tile_size(tile_size),
+      pixels(static_cast<size_t>(width) * height, 0xff000000u)
+{
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+
+    if (listen_fd < 0
+        || setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) != 0
+        || bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(listen_fd, 1) != 0
+        || pipe(wake_pipe) != 0) {
+        std::cerr << "Erro ao abrir a porta " << port << " para o streaming" << std::endl;
+        if (listen_fd >= 0) close(listen_fd);
+        listen_fd = -1;
+        return;
+    }
+    // As duas pontas: sem visualizador o pipe enche, e `refresh` não pode travar o render
+    fcntl(wake_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(wake_pipe[1], F_SETFL, O_NONBLOCK);
+
+    worker = std::thread(&FrameStreamer::run, this);
+}
+
+FrameStreamer::~FrameStreamer() {
+    if (worker.joinable()) {
+        stop = true;
+        char byte = 0;
+        (void)!write(wake_pipe[1], &byte, 1);
+        worker.join();
+    }
+    disconnect();
+    for (int fd : {listen_fd, wake_pipe[0], wake_pipe[1]})
+        if (fd >= 0) close(fd);
+}
+
+void FrameStreamer::refresh() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        staging = pixels;
+        staging_seq = applied_seq;
+        pending = true;
+    }
+    char byte = 0;
+    (void)!write(wake_pipe[1], &byte, 1);
+}
+
+void FrameStreamer::set_title(const std::string& title) {
+    std::lock_guard<std::mutex> lock(mutex);
+    staging_title = title;
+}
+
+bool FrameStreamer::process_input(camera& cam) {
+    std::lock_guard<std::mutex> lock(mutex);
+    bool moved = false;
+    for (const StreamKey& k : keys) {
+        moved = cam.move(k.key) || moved;
+        applied_seq = k.seq;
+    }
+    keys.clear();
+    return moved;
+}
+
+void FrameStreamer::run() {
+    while (!stop) {
+        if (client_fd < 0) {
+            accept_viewer();
+            continue;
+        }
+
+        pollfd fds[2] = {{client_fd, POLLIN, 0}, {wake_pipe[0], POLLIN, 0}};
+        if (poll(fds, 2, 100) < 0) continue;
+
+        if (fds[1].revents & POLLIN) drain(wake_pipe[0]);
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) read_keys();
+        if (client_fd >= 0 && !send_update()) disconnect();
+    }
+}
+
+void FrameStreamer::accept_viewer() {
+    pollfd fds[2] = {{listen_fd, POLLIN, 0}, {wake_pipe[0], POLLIN, 0}};
+    if (poll(fds, 2, 100) <= 0) return;
+    // Quadros sem visualizador não interessam; sem esvaziar, o poll voltaria na hora para sempre
+    if (fds[1].revents & POLLIN) drain(wake_pipe[0]);
+    if (!(fds[0].revents & POLLIN)) return;
+
+    client_fd = accept(listen_fd, nullptr, nullptr);
+    if (client_fd < 0) return;
+
+    // Tiles pequenos não devem esperar o algoritmo de Nagle
+    int yes = 1;
+    setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+    StreamHello hello = {};
+    std::memcpy(hello.magic, stream_magic, sizeof(hello.magic));
+    hello.tile_size = static_cast<uint16_t>(tile_size);
+    hello.width = width;
+    hello.height = height;
+    if (!send_all(client_fd, &hello, sizeof(hello))) {
+        disconnect();
+        return;
+    }
+
+    // Alfa zero nunca aparece no framebuffer: o primeiro envio manda todos os tiles
+    sent.assign(pixels.size(), 0);
+    received.clear();
+    std::lock_guard<std::mutex> lock(mutex);
+    pending = !staging.empty();
+}
+
+void FrameStreamer::read_keys() {
+    uint8_t buffer[256];
+    ssize_t n = recv(client_fd, buffer, sizeof(buffer), 0);
+    if (n <= 0) {
+        disconnect();
+        return;
+    }
+    received.insert(received.end(), buffer, buffer + n);
+
+    size_t complete = received.size() / sizeof(StreamKey) * sizeof(StreamKey);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t offset = 0; offset < complete; offset += sizeof(StreamKey)) {
+        StreamKey k;
+        std::memcpy(&k, received.data() + offset, sizeof(k));
+        keys.push_back(k);
+    }
+    received.erase(received.begin(), received.begin() + complete);
+}
+
+bool FrameStreamer::send_update() {
+    StreamFrame frame = {};
+    std::string title;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!pending) return true;
+        current = staging;
+        title = staging_title;
+        frame.input_seq = staging_seq;
+        pending = false;
+    }
+
+    message.clear();
+    append(message, frame);
+    message.insert(message.end(), title.begin(), title.end());
+
+    // Só os tiles diferentes do que o visualizador já tem
+    std::vector<uint8_t> encoded;
+    for (int y0 = 0; y0 < height; y0 += tile_size) {
+        for (int x0 = 0; x0 < width; x0 += tile_size) {
+            const int w = std::min(tile_size, width - x0);
+            const int h = std::min(tile_size, height - y0);
+            const size_t first = static_cast<size_t>(y0) * width + x0;
+
+            bool changed = false;
+            for (int y = 0; y < h && !changed; ++y)
+                changed = std::memcmp(&current[first + static_cast<size_t>(y) * width],
+                                      &sent[first + static_cast<size_t>(y) * width], w * sizeof(uint32_t)) != 0;
+            if (!changed) continue;
+
+            encode_tile(&current[first], width, w, h, encoded);
+            StreamTile tile = {static_cast<uint16_t>(x0), static_cast<uint16_t>(y0),
+                               static_cast<uint16_t>(w), static_cast<uint16_t>(h),
+                               static_cast<uint32_t>(encoded.size())};
+            append(message, tile);
+            message.insert(message.end(), encoded.begin(), encoded.end());
+            for (int y = 0; y < h; ++y)
+                std::memcpy(&sent[first + static_cast<size_t>(y) * width],
+                            &current[first + static_cast<size_t>(y) * width], w * sizeof(uint32_t));
+            frame.tile_count++;
+        }
+    }
+
+    frame.title_bytes = static_cast<uint32_t>(title.size());
+    std::memcpy(message.data(), &frame, sizeof(frame));
+    return send_all(client_fd, message.data(), message.size());
+}
+
+void FrameStreamer::disconnect() {
+    if (client_fd >= 0) close(client_fd);
+    client_fd = -1;
+}
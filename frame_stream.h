@@ -0,0 +1,134 @@
+#pragma once
+
+#include "display.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Protocolo entre `FrameStreamer` e o visualizador (`viewer.cpp`), sobre TCP.
+ * Todos os campos são little-endian, sem preenchimento entre as structs.
+ *
+ *   servidor -> visualizador: `StreamHello` ao conectar; depois, para cada
+ *     atualização, um `StreamFrame`, o título (`title_bytes` bytes) e
+ *     `tile_count` pares `StreamTile` + dados comprimidos (`encode_tile`)
+ *   visualizador -> servidor: `StreamKey` a cada tecla de movimento
+ *
+ * `input_seq` do quadro é a última tecla já aplicada à câmera quando o
+ * quadro foi gerado: o visualizador mede a latência de cada tecla até o
+ * primeiro quadro que a inclui.
+ */
+const char stream_magic[4] = {'R', 'T', 'S', '1'};
+
+#pragma pack(push, 1)
+struct StreamHello {
+    char magic[4];
+    uint16_t tile_size;
+    uint16_t reserved;
+    int32_t width;
+    int32_t height;
+};
+
+struct StreamFrame {
+    uint32_t input_seq;
+    uint32_t tile_count;
+    uint32_t title_bytes;
+};
+
+struct StreamTile {
+    uint16_t x, y, width, height;
+    uint32_t bytes;
+};
+
+struct StreamKey {
+    uint32_t seq;
+    char key; // 'w', 'a', 's' ou 'd'
+};
+#pragma pack(pop)
+
+/**
+ * @brief Comprime um retângulo de pixels ARGB8888 (o alfa é descartado)
+ *
+ * Cada canal vira um plano com a diferença para o pixel à esquerda (o
+ * primeiro de cada linha usa o de cima), e o plano é comprimido com RLE de
+ * bytes no estilo PackBits: céu e regiões já convergidas viram corridas de
+ * diferenças iguais. Controle `c` < 128: `c + 1` bytes literais seguem;
+ * `c` >= 128: o próximo byte se repete `c - 125` vezes.
+ *
+ * @param stride Pixels por linha de `pixels`
+ * @param out Recebe os dados (é sobrescrito)
+ */
+void encode_tile(const uint32_t* pixels, int stride, int width, int height, std::vector<uint8_t>& out);
+
+/**
+ * @brief Descomprime o que `encode_tile` gerou
+ * @return false se os dados estiverem truncados ou inconsistentes
+ */
+bool decode_tile(const uint8_t* data, size_t size, uint32_t* pixels, int stride, int width, int height);
+
+/**
+ * @class FrameStreamer
+ * @brief `Display` que transmite os quadros para um visualizador remoto por TCP
+ *
+ * Escuta em `port` e atende um visualizador por vez. `refresh` só copia o
+ * framebuffer para uma área de espera; a thread de rede compara a cópia mais
+ * recente com o que o visualizador já tem e envia só os tiles que mudaram,
+ * comprimidos. Se a rede for mais lenta que o render, quadros intermediários
+ * são pulados: cada envio leva o estado mais novo. As teclas recebidas são
+ * aplicadas à câmera em `process_input`, como as da janela local.
+ */
+class FrameStreamer : public Display {
+public:
+    /**
+     * @param port Porta TCP (todas as interfaces)
+     * @param tile_size Lado dos tiles comparados e enviados, em pixels
+     */
+    FrameStreamer(int port, int width, int height, int tile_size = 32);
+
+    /// Encerra a conexão e a thread de rede
+    ~FrameStreamer();
+
+    /// A porta não pôde ser aberta
+    bool failed() const { return listen_fd < 0; }
+
+    uint32_t* pixel_buffer() override { return pixels.data(); }
+    void refresh() override;
+    void set_title(const std::string& title) override;
+    bool process_input(camera& cam) override;
+    bool should_close() override { return false; }
+
+private:
+    void run();
+    void accept_viewer();
+    void read_keys();
+    bool send_update();
+    void disconnect();
+
+    const int width, height, tile_size;
+    std::vector<uint32_t> pixels; // Escrito pelo render
+
+    std::mutex mutex;
+    std::vector<uint32_t> staging; // Último quadro de `refresh`
+    std::string staging_title;
+    uint32_t staging_seq = 0;
+    bool pending = false;
+    std::vector<StreamKey> keys;   // Recebidas e ainda não aplicadas
+    uint32_t applied_seq = 0;      // Só o render mexe
+
+    // Só a thread de rede mexe
+    std::vector<uint32_t> sent;    // O que o visualizador tem na tela
+    std::vector<uint32_t> current;
+    std::vector<uint8_t> message;
+    std::vector<uint8_t> received;
+
+    int listen_fd = -1;
+    int client_fd = -1;
+    int wake_pipe[2] = {-1, -1};   // Acorda a thread de rede no `poll`
+    std::atomic<bool> stop{false};
+    std::thread worker;
+};
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "ray.h"
-#include <memory> // Para shared_ptr
+#include "aabb.h"
+#include "ray_packet.h"
+#include <cstdint>
 
 class material;
+class hittable;
 
 /**
  * @struct hit_record
@@ -13,13 +16,20 @@ class material;
  * - o ponto da colisão (`p`)
  * - a normal da superfície no ponto (`normal`)
  * - a distância ao longo do raio (`t`)
- * - um ponteiro para o material do objeto atingido (`mat_ptr`)
+ * - um ponteiro (não proprietário) para o material do objeto atingido (`mat_ptr`)
+ * - se o raio atingiu o lado de fora da superfície (`front_face`)
+ * - o objeto atingido (`object`), usado para achar a luz na amostragem de luzes
+ *   e as coordenadas de textura (`hittable::surface_uv`)
+ * - a primitiva atingida dentro do objeto (`primitive`), para objetos com várias
  */
 struct hit_record {
     point3 p;
     vec3 normal;
-    std::shared_ptr<material> mat_ptr;
+    const material* mat_ptr; // O objeto atingido é quem mantém o material vivo
     double t;
+    bool front_face;
+    const hittable* object = nullptr;
+    uint32_t primitive = 0;
 };
 
 /**
@@ -43,4 +53,85 @@ public:
      * @return true se o objeto for atingido; false caso contrário
      */
     virtual bool hit(const ray& r, double t_min, double t_max, hit_record& rec) const = 0;
+
+    /**
+     * @brief Verifica se o raio atinge o objeto em qualquer ponto do intervalo
+     *
+     * Consulta de oclusão (raios de sombra e visibilidade): não calcula ponto,
+     * normal nem material, e pode parar no primeiro hit encontrado, que não
+     * precisa ser o mais próximo.
+     *
+     * @param r Raio lançado
+     * @param t_min Valor mínimo de t a considerar
+     * @param t_max Valor máximo de t a considerar
+     *
+     * @return true se houver alguma colisão em `[t_min, t_max]`
+     */
+    virtual bool hit_any(const ray& r, double t_min, double t_max) const {
+        hit_record rec;
+        return hit(r, t_min, t_max, rec);
+    }
+
+    /**
+     * @brief Verifica quais raios de um pacote (origem comum) atingem o objeto
+     *
+     * Equivale a chamar `hit` para cada raio; estruturas de aceleração podem
+     * percorrer o pacote junto.
+     *
+     * @param rec Vetor com `packet.count` registros; `rec[k]` vale se o bit k do retorno está ligado
+     * @return Máscara dos raios que atingiram o objeto
+     */
+    virtual uint64_t hit_packet(const ray_packet& packet, double t_min, double t_max, hit_record* rec) const {
+        uint64_t mask = 0;
+        for (int k = 0; k < packet.count; ++k)
+            if (hit(packet.rays[k], t_min, t_max, rec[k])) mask |= uint64_t(1) << k;
+        return mask;
+    }
+
+    /**
+     * @brief Coordenadas de textura do ponto de `rec`
+     *
+     * Calculadas só por materiais com textura, não em cada `hit`.
+     *
+     * @param rec Registro preenchido por `hit` deste objeto
+     * @param u, v Recebem as coordenadas, em [0, 1]
+     * @return Comprimento na superfície que corresponde a uma unidade de `v`
+     *         (converte a pegada do raio em pegada na textura); 0 se o objeto
+     *         não tem coordenadas de textura
+     */
+    virtual double surface_uv(const hit_record& rec, double& u, double& v) const {
+        u = v = 0;
+        return 0;
+    }
+
+    /**
+     * @brief Caixa que contém o objeto
+     *
+     * @param output_box Recebe a caixa
+     * @return false se o objeto não tiver caixa finita (não pode entrar numa BVH)
+     */
+    virtual bool bounding_box(aabb& output_box) const {
+        return false;
+    }
+
+    /**
+     * @brief Densidade (por ângulo sólido) de `random` gerar a direção dada
+     *
+     * Só precisa ser implementado por objetos usados como fontes de luz.
+     *
+     * @param origin Ponto de onde a direção parte
+     * @param direction Direção a avaliar
+     */
+    virtual double pdf_value(const point3& origin, const vec3& direction) const {
+        return 0.0;
+    }
+
+    /**
+     * @brief Sorteia uma direção de `origin` em direção ao objeto
+     */
+    virtual vec3 random(const point3& origin) const {
+        return vec3(1, 0, 0);
+    }
+
+    virtual ~hittable() = default;
 };
@@ -42,6 +42,16 @@ class hittable_list : public hittable {
         */
         virtual bool hit(const ray& r, double t_min, double t_max, hit_record& rec) const override;
 
+        /**
+        * @brief Teste de oclusão: retorna no primeiro objeto atingido.
+        */
+        virtual bool hit_any(const ray& r, double t_min, double t_max) const override;
+
+        /**
+        * @brief Caixa que contém todos os objetos (false se algum não tiver caixa).
+        */
+        virtual bool bounding_box(aabb& output_box) const override;
+
     public:
         std::vector<shared_ptr<hittable>> objects;
 };
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include "image_texture.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char mip_magic[8] = {'R', 'T', 'M', 'I', 'P', '1', '\0', '\0'};
+const uint32_t mip_version = 1;
+
+// Cabeçalho do arquivo (32 bytes)
+struct MipHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    uint16_t tile_size;
+    uint16_t levels;
+    uint64_t reserved;
+};
+static_assert(sizeof(MipHeader) == 32, "cabeçalho da textura deve ter 32 bytes");
+
+/// Tabela sRGB (8 bits) -> linear
+const float* srgb_to_linear() {
+    static const auto table = [] {
+        std::vector<float> t(256);
+        for (int k = 0; k < 256; ++k) {
+            float s = k / 255.0f;
+            t[k] = s <= 0.04045f ? s / 12.92f : std::pow((s + 0.055f) / 1.055f, 2.4f);
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+uint8_t linear_to_srgb(float v) {
+    v = std::clamp(v, 0.0f, 1.0f);
+    float s = v <= 0.0031308f ? 12.92f * v : 1.055f * std::pow(v, 1 / 2.4f) - 0.055f;
+    return static_cast<uint8_t>(s * 255 + 0.5f);
+}
+
+int level_count(int width, int height) {
+    int levels = 1;
+    while (std::max(width, height) >> (levels - 1) > 1) ++levels;
+    return levels;
+}
+
+} // namespace
+
+std::shared_ptr<image_texture> image_texture::open(const std::string& path, TileCache& cache) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    MipHeader header;
+    struct stat st;
+    if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) || fstat(fd, &st) != 0) {
+        close(fd);
+        return nullptr;
+    }
+#else
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return nullptr;
+    MipHeader header;
+    bool read = std::fread(&header, sizeof(header), 1, file) == 1;
+    std::fclose(file);
+    if (!read) return nullptr;
+#endif
+
+    bool valid = std::memcmp(header.magic, mip_magic, sizeof(header.magic)) == 0
+              && header.version == mip_version
+              && header.width > 0 && header.height > 0 && header.tile_size > 0
+              && header.levels == level_count(header.width, header.height);
+
+    std::shared_ptr<image_texture> tex(new image_texture(cache));
+    if (valid) {
+        tex->tile_size = header.tile_size;
+        const uint64_t tile_bytes = 3ull * header.tile_size * header.tile_size;
+        uint64_t offset = sizeof(MipHeader);
+        for (int level = 0; level < header.levels; ++level) {
+            int w = std::max(1, header.width >> level);
+            int h = std::max(1, header.height >> level);
+            int tx = (w + header.tile_size - 1) / header.tile_size;
+            int ty = (h + header.tile_size - 1) / header.tile_size;
+            tex->level_width.push_back(w);
+            tex->level_height.push_back(h);
+            tex->tiles_x.push_back(tx);
+            tex->level_offset.push_back(offset);
+            offset += tile_bytes * tx * ty;
+        }
+#ifndef _WIN32
+        valid = static_cast<uint64_t>(st.st_size) == offset;
+#endif
+    }
+
+#ifndef _WIN32
+    if (!valid) {
+        close(fd);
+        return nullptr;
+    }
+    tex->fd = fd;
+#else
+    if (!valid) return nullptr;
+    tex->path = path;
+#endif
+    tex->id = cache.register_texture();
+    return tex;
+}
+
+image_texture::~image_texture() {
+#ifndef _WIN32
+    if (fd >= 0) close(fd);
+#endif
+}
+
+bool image_texture::write(const std::string& path, int width, int height,
+                          const std::vector<uint8_t>& srgb, int tile_size) {
+    if (width <= 0 || height <= 0 || tile_size <= 0 || srgb.size() != 3ull * width * height) return false;
+
+    MipHeader header = {};
+    std::memcpy(header.magic, mip_magic, sizeof(header.magic));
+    header.version = mip_version;
+    header.width = width;
+    header.height = height;
+    header.tile_size = static_cast<uint16_t>(tile_size);
+    header.levels = static_cast<uint16_t>(level_count(width, height));
+
+    // Arquivo temporário renomeado no fim, como nos checkpoints
+    std::string tmp_path = path + ".tmp";
+    std::FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Erro ao gravar textura: " << tmp_path << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    const float* to_linear = srgb_to_linear();
+    std::vector<uint8_t> level = srgb, next;
+    std::vector<uint8_t> tile(3ull * tile_size * tile_size);
+    int w = width, h = height;
+
+    for (int l = 0; l < header.levels && ok; ++l) {
+        // Tiles do nível, com as bordas completadas pelo último texel
+        for (int ty = 0; ty < (h + tile_size - 1) / tile_size; ++ty) {
+            for (int tx = 0; tx < (w + tile_size - 1) / tile_size; ++tx) {
+                for (int y = 0; y < tile_size; ++y) {
+                    int sy = std::min(ty * tile_size + y, h - 1);
+                    for (int x = 0; x < tile_size; ++x) {
+                        int sx = std::min(tx * tile_size + x, w - 1);
+                        std::memcpy(&tile[3 * (y * tile_size + x)], &level[3 * (size_t(sy) * w + sx)], 3);
+                    }
+                }
+                ok = ok && std::fwrite(tile.data(), 1, tile.size(), file) == tile.size();
+            }
+        }
+
+        // Próximo nível: média 2x2 em cor linear
+        int nw = std::max(1, w / 2), nh = std::max(1, h / 2);
+        next.assign(3ull * nw * nh, 0);
+        for (int y = 0; y < nh; ++y) {
+            for (int x = 0; x < nw; ++x) {
+                for (int c = 0; c < 3; ++c) {
+                    float sum = 0;
+                    for (int dy = 0; dy < 2; ++dy)
+                        for (int dx = 0; dx < 2; ++dx) {
+                            int sx = std::min(2 * x + dx, w - 1), sy = std::min(2 * y + dy, h - 1);
+                            sum += to_linear[level[3 * (size_t(sy) * w + sx) + c]];
+                        }
+                    next[3 * (size_t(y) * nw + x) + c] = linear_to_srgb(sum / 4);
+                }
+            }
+        }
+        std::swap(level, next);
+        w = nw;
+        h = nh;
+    }
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::cerr << "Erro ao gravar textura: " << path << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+TileCache::tile_ptr image_texture::load_tile(int level, int x, int y) const {
+    auto loaded = std::make_shared<TileCache::tile>(3ull * tile_size * tile_size);
+    const uint64_t offset = level_offset[level] + loaded->size() * (uint64_t(y) * tiles_x[level] + x);
+
+#ifndef _WIN32
+    // pread não mexe na posição do arquivo: várias threads leem o mesmo descritor
+    bool ok = pread(fd, loaded->data(), loaded->size(), static_cast<off_t>(offset)) == static_cast<ssize_t>(loaded->size());
+#else
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    bool ok = file && _fseeki64(file, static_cast<long long>(offset), SEEK_SET) == 0
+           && std::fread(loaded->data(), 1, loaded->size(), file) == loaded->size();
+    if (file) std::fclose(file);
+#endif
+
+    if (!ok) {
+        // Tile ilegível fica preto; o aviso sai uma vez só
+        static std::atomic<bool> warned{false};
+        if (!warned.exchange(true)) std::cerr << "Erro ao ler tile de textura" << std::endl;
+        std::fill(loaded->begin(), loaded->end(), 0);
+    }
+    return loaded;
+}
+
+color image_texture::texel(int level, int x, int y, TileCache::tile_ptr& tile, uint64_t& tile_key) const {
+    const int tx = x / tile_size, ty = y / tile_size;
+    const uint64_t key = TileCache::key(id, level, tx, ty);
+    if (key != tile_key) {
+        tile = cache.find(key);
+        if (!tile) tile = cache.insert(key, load_tile(level, tx, ty));
+        tile_key = key;
+    }
+
+    const float* to_linear = srgb_to_linear();
+    const uint8_t* t = tile->data() + 3 * ((y - ty * tile_size) * tile_size + (x - tx * tile_size));
+    return color(to_linear[t[0]], to_linear[t[1]], to_linear[t[2]]);
+}
+
+color image_texture::bilinear(int level, double u, double v) const {
+    const int w = level_width[level], h = level_height[level];
+    double x = (u - std::floor(u)) * w - 0.5;
+    double y = (1 - std::clamp(v, 0.0, 1.0)) * h - 0.5; // Linha 0 é o topo da imagem
+
+    int x0 = static_cast<int>(std::floor(x)), y0 = static_cast<int>(std::floor(y));
+    double fx = x - x0, fy = y - y0;
+
+    // u se repete, v fica preso na borda
+    int x1 = x0 + 1 == w ? 0 : x0 + 1;
+    if (x0 < 0) x0 += w;
+    int y1 = std::min(y0 + 1, h - 1);
+    y0 = std::max(y0, 0);
+
+    // Os 4 texels quase sempre estão no mesmo tile: uma busca no cache só
+    TileCache::tile_ptr tile;
+    uint64_t tile_key = ~uint64_t(0);
+    color c00 = texel(level, x0, y0, tile, tile_key);
+    color c10 = texel(level, x1, y0, tile, tile_key);
+    color c01 = texel(level, x0, y1, tile, tile_key);
+    color c11 = texel(level, x1, y1, tile, tile_key);
+
+    return (1 - fy) * ((1 - fx) * c00 + fx * c10) + fy * ((1 - fx) * c01 + fx * c11);
+}
+
+color image_texture::value(double u, double v, double footprint) const {
+    // Nível em que a pegada cobre um texel
+    const int last = levels() - 1;
+    const double level = std::log2(footprint * height());
+    if (!(level > 0)) return bilinear(0, u, v); // Também cobre footprint = 0
+    if (level >= last) return bilinear(last, u, v);
+
+    const int l0 = static_cast<int>(level);
+    const double f = level - l0;
+    return (1 - f) * bilinear(l0, u, v) + f * bilinear(l0 + 1, u, v);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "texture.h"
+#include "tile_cache.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class image_texture
+ * @brief Textura de imagem lida do disco sob demanda, em tiles de uma pirâmide de mips
+ *
+ * O arquivo (`.rtmip`) guarda todos os níveis de mip, do maior ao 1x1, cada
+ * um cortado em tiles quadrados de `tile_size` texels RGB de 8 bits
+ * (codificados em sRGB). Os tiles das bordas são completados repetindo o
+ * último texel, então todo tile tem o mesmo tamanho e a posição de cada um
+ * no arquivo sai do cabeçalho. Só os tiles usados são lidos, através do
+ * `TileCache`, que limita a memória de todas as texturas juntas.
+ *
+ * A filtragem é trilinear: o nível vem de log2 da pegada em texels, e os
+ * dois níveis vizinhos são interpolados bilinearmente. `u` se repete;
+ * `v` fica preso na borda.
+ */
+class image_texture : public texture {
+    public:
+        /**
+         * @brief Abre uma textura gravada por `write`
+         * @return nullptr se o arquivo não existir ou não for uma pirâmide válida
+         */
+        static std::shared_ptr<image_texture> open(const std::string& path, TileCache& cache);
+
+        /**
+         * @brief Gera a pirâmide de mips de uma imagem e grava no formato lido por `open`
+         *
+         * Cada nível é a média 2x2 (em cor linear) do anterior.
+         *
+         * @param srgb Texels RGB de 8 bits em sRGB, linha a linha a partir do topo
+         * @return false se não conseguir gravar o arquivo
+         */
+        static bool write(const std::string& path, int width, int height,
+                          const std::vector<uint8_t>& srgb, int tile_size = 64);
+
+        ~image_texture();
+
+        virtual color value(double u, double v, double footprint) const override;
+
+        int width() const { return level_width[0]; }
+        int height() const { return level_height[0]; }
+        int levels() const { return static_cast<int>(level_width.size()); }
+
+    private:
+        image_texture(TileCache& cache) : cache(cache) {}
+
+        /// Texel (x, y) do nível `level`, em cor linear; `tile` guarda o último tile usado
+        color texel(int level, int x, int y, TileCache::tile_ptr& tile, uint64_t& tile_key) const;
+
+        color bilinear(int level, double u, double v) const;
+
+        TileCache::tile_ptr load_tile(int level, int x, int y) const;
+
+        TileCache& cache;
+        uint32_t id = 0;
+#ifndef _WIN32
+        int fd = -1;
+#else
+        std::string path;
+#endif
+        int tile_size = 0;
+        std::vector<int> level_width, level_height, tiles_x;
+        std::vector<uint64_t> level_offset; // Posição do primeiro tile de cada nível no arquivo
+};
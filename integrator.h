@@ -3,14 +3,45 @@
 #include "hittable.h"
 #include "color.h"
 #include "material.h"
+#include "light_sampler.h"
+#include "irradiance_cache.h"
+#include "ray_batch.h"
+#include "random.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 // Interface abstrata (Strategy)
 class Integrator {
 public:
     virtual ~Integrator() = default;
-    
+
     // O método principal que calcula a cor de um raio
     virtual color Li(const ray& r, const hittable& scene, int depth) const = 0;
+
+    // Calcula `batch.radiance` de todos os caminhos do lote. O resultado é o
+    // mesmo de `Li` caminho a caminho; integradores que sabem traçar o lote
+    // por rebatida podem reordenar os raios (`reorder`) para a travessia ficar coerente.
+    virtual void Li_batch(RayBatch& batch, const hittable& scene, int depth, bool reorder) const {
+        for (size_t k = 0; k < batch.size(); ++k) {
+            random_state() = batch.rng[k];
+            batch.radiance[k] = Li(batch.rays[k], scene, depth);
+            batch.rng[k] = random_state();
+        }
+    }
+
+    // Se falso, o fundo é preto e a cena só é iluminada pelos materiais emissivos
+    bool sky = true;
+
+protected:
+    // Fundo (Skybox)
+    color background(const ray& r) const {
+        if (!sky) return color(0,0,0);
+
+        vec3 unit_direction = unit_vector(r.direction());
+        auto t = 0.5 * (unit_direction.y() + 1.0);
+        return (1.0 - t) * color(1.0, 1.0, 1.0) + t * color(0.5, 0.7, 1.0);
+    }
 };
 
 // Implementação concreta: O algoritmo recursivo clássico
@@ -28,21 +59,337 @@ public:
         if (scene.hit(r, 0.001, infinity, rec)) {
             ray scattered;
             color attenuation;
-            
+            color emitted = rec.mat_ptr->emitted(r, rec);
+
             // Polimorfismo do material (já existente no seu código)
             if (rec.mat_ptr->scatter(r, rec, attenuation, scattered)) {
                 // Chama recursivamente Li em vez de ray_color
-                return attenuation * Li(scattered, scene, depth - 1);
+                return emitted + attenuation * Li(scattered, scene, depth - 1);
             }
-            return color(0,0,0);
+            return emitted;
         }
 
-        // Fundo (Skybox)
-        vec3 unit_direction = unit_vector(r.direction());
-        auto t = 0.5 * (unit_direction.y() + 1.0);
-        return (1.0 - t) * color(1.0, 1.0, 1.0) + t * color(0.5, 0.7, 1.0);
+        return background(r);
     }
 
 private:
     int max_depth;
-};
\ No newline at end of file
+};
+
+// Implementação concreta: path tracing com amostragem explícita de luzes
+// (next-event estimation) combinada à amostragem do material por MIS
+class PathIntegrator : public Integrator {
+public:
+    PathIntegrator(int max_depth, const LightSampler& lights) : max_depth(max_depth), lights(lights) {}
+
+    color Li(const ray& r, const hittable& scene, int depth) const override {
+        return trace(r, scene, depth, true);
+    }
+
+    // Traça o lote uma rebatida por vez: primeiro a travessia de todos os
+    // raios ativos, depois o sombreamento. Da segunda rebatida em diante, com
+    // `reorder`, os raios são ordenados por direção e origem antes da travessia;
+    // com `batch.packets`, a primeira travessia é feita em pacotes.
+    void Li_batch(RayBatch& batch, const hittable& scene, int depth, bool reorder) const override {
+        const size_t n = batch.size();
+        std::vector<path_state> paths(n);
+        batch.order.resize(n);
+        batch.hits.resize(n);
+        batch.found.resize(n);
+        for (size_t k = 0; k < n; ++k) {
+            paths[k].current = batch.rays[k];
+            batch.order[k] = static_cast<uint32_t>(k);
+        }
+
+        for (int bounce = 0; bounce < depth && !batch.order.empty(); ++bounce) {
+            if (reorder && bounce > 0) sort_rays(batch);
+
+            if (bounce == 0 && batch.packets) {
+                intersect_packets(batch, scene, 0.001, infinity);
+            } else {
+                for (uint32_t k : batch.order)
+                    batch.found[k] = scene.hit(batch.rays[k], 0.001, infinity, batch.hits[k]);
+            }
+
+            size_t active = 0;
+            for (uint32_t k : batch.order) {
+                random_state() = batch.rng[k];
+                bool alive = extend(paths[k], batch.found[k], batch.hits[k], scene, true, depth - bounce - 1);
+                batch.rng[k] = random_state();
+                if (!alive) continue;
+
+                batch.rays[k] = paths[k].current;
+                batch.order[active++] = k;
+            }
+            batch.order.resize(active);
+        }
+
+        for (size_t k = 0; k < n; ++k) batch.radiance[k] = paths[k].L;
+    }
+
+protected:
+    /**
+     * @brief Traça o caminho que começa em `r`
+     *
+     * @param first_emission Se falso, a emissão do primeiro ponto atingido não
+     *        é somada (quem chamou já a cobriu amostrando as luzes)
+     * @param first_distance Se não nulo, recebe a distância até o primeiro
+     *        ponto atingido (infinito se o raio escapou)
+     * @param plain Se verdadeiro, `diffuse_vertex` não é chamado: path tracing puro
+     */
+    color trace(const ray& r, const hittable& scene, int depth, bool first_emission,
+                double* first_distance = nullptr, bool plain = false) const {
+        path_state path;
+        path.current = r;
+        path.plain = plain;
+        if (first_distance) *first_distance = infinity;
+
+        for (int bounce = 0; bounce < depth; ++bounce) {
+            hit_record rec;
+            bool found = scene.hit(path.current, 0.001, infinity, rec);
+            if (bounce == 0 && found && first_distance)
+                *first_distance = rec.t * path.current.direction().length();
+
+            if (!extend(path, found, rec, scene, bounce > 0 || first_emission, depth - bounce - 1))
+                break;
+        }
+
+        return path.L;
+    }
+
+    // Estado de um caminho entre duas rebatidas
+    struct path_state {
+        color L{0,0,0};
+        color throughput{1,1,1};
+        ray current;
+
+        // Dados do vértice anterior, para pesar a emissão atingida por acaso
+        bool specular_bounce = true;
+        double bsdf_pdf = 0;
+        point3 previous_point;
+
+        int diffuse_vertices = 0; // Vértices com BSDF não singular até aqui
+        bool plain = false;       // Sem `diffuse_vertex` (ex.: raios que calculam o cache)
+    };
+
+    // Soma a luz do ponto atingido por `path.current` (ou do fundo, se `found`
+    // é falso) e gera o próximo raio. Retorna false se o caminho terminou.
+    // `remaining` é quantas rebatidas ainda cabem depois desta.
+    bool extend(path_state& path, bool found, const hit_record& rec, const hittable& scene,
+                bool count_emission, int remaining) const {
+        if (!found) {
+            path.L += path.throughput * background(path.current);
+            return false;
+        }
+
+        // Emissão encontrada pela amostragem do material
+        color emitted = rec.mat_ptr->emitted(path.current, rec);
+        if (!count_emission) {
+            emitted = color(0,0,0);
+        } else if (!path.specular_bounce) {
+            double light_pdf = lights.pdf(rec.object, path.previous_point, path.current.direction());
+            emitted = emitted * power_heuristic(path.bsdf_pdf, light_pdf);
+        }
+        path.L += path.throughput * emitted;
+
+        ray scattered;
+        color attenuation;
+        if (!rec.mat_ptr->scatter(path.current, rec, attenuation, scattered))
+            return false;
+
+        double pdf = rec.mat_ptr->scattering_pdf(path.current, rec, scattered);
+        if (pdf > 0) {
+            path.diffuse_vertices++;
+            if (!path.plain && diffuse_vertex(path, rec, attenuation, scene, remaining))
+                return false;
+        }
+        if (pdf > 0 && !lights.empty())
+            path.L += path.throughput * sample_light(path.current, rec, attenuation, scene);
+
+        path.throughput = path.throughput * attenuation;
+        path.specular_bounce = (pdf == 0);
+        path.bsdf_pdf = pdf;
+        path.previous_point = rec.p;
+        path.current = scattered;
+        return true;
+    }
+
+    // Gancho em cada vértice com BSDF não singular, antes da amostragem das
+    // luzes. Uma subclasse pode terminar o caminho ali (retornando true)
+    // depois de somar a luz do vértice em `path.L` por outro estimador.
+    virtual bool diffuse_vertex(path_state& path, const hit_record& rec, const color& attenuation,
+                                const hittable& scene, int remaining) const {
+        return false;
+    }
+
+    // Amostra uma luz e traça o raio de sombra até ela. Sem `mis`, a luz não
+    // divide o peso com a amostragem do material (o caminho termina aqui).
+    color sample_light(const ray& r_in, const hit_record& rec, const color& attenuation,
+                       const hittable& scene, bool mis = true) const {
+        double pick_probability;
+        const hittable& light = lights.sample(pick_probability);
+
+        ray to_light(rec.p, light.random(rec.p));
+
+        hit_record light_rec;
+        if (!light.hit(to_light, 0.001, infinity, light_rec))
+            return color(0,0,0);
+
+        color Le = light_rec.mat_ptr->emitted(to_light, light_rec);
+        if (Le.near_zero())
+            return color(0,0,0);
+
+        // Sombra: algo entre o ponto e a luz?
+        if (scene.hit_any(to_light, 0.001, light_rec.t * (1 - 1e-6)))
+            return color(0,0,0);
+
+        double light_pdf = pick_probability * light.pdf_value(rec.p, to_light.direction());
+        double bsdf_pdf = rec.mat_ptr->scattering_pdf(r_in, rec, to_light);
+        if (light_pdf <= 0 || bsdf_pdf <= 0)
+            return color(0,0,0);
+
+        // attenuation * bsdf_pdf = BSDF * cosseno na direção da luz
+        double weight = mis ? power_heuristic(light_pdf, bsdf_pdf) : 1.0;
+        return attenuation * bsdf_pdf * Le * (weight / light_pdf);
+    }
+
+    static double power_heuristic(double pdf_a, double pdf_b) {
+        auto a2 = pdf_a * pdf_a;
+        auto b2 = pdf_b * pdf_b;
+        return (a2 + b2) > 0 ? a2 / (a2 + b2) : 1.0;
+    }
+
+    int max_depth;
+    const LightSampler& lights;
+};
+
+// Implementação concreta: path tracing em que, no segundo vértice difuso do
+// caminho, a luz direta vem das luzes amostradas e a indireta é interpolada
+// de um cache de irradiância. Onde o cache não cobre o ponto, um registro
+// novo é calculado ali (refinamento sob demanda) e inserido. O laço do
+// caminho é o do PathIntegrator (`diffuse_vertex`), inclusive em lote.
+class IrradianceCacheIntegrator : public PathIntegrator {
+public:
+    /**
+     * @param cache Cache compartilhado pelas threads de render
+     * @param gather_rays Raios por registro, estratificados em M x N (N ~ pi M)
+     */
+    IrradianceCacheIntegrator(int max_depth, const LightSampler& lights, IrradianceCache& cache,
+                              int gather_rays = 128)
+        : PathIntegrator(max_depth, lights), cache(cache)
+    {
+        theta_strata = std::max(2, static_cast<int>(std::lround(std::sqrt(gather_rays / pi))));
+        phi_strata = std::max(3, static_cast<int>(std::lround(pi * theta_strata)));
+    }
+
+protected:
+    // No segundo vértice difuso, a luz direta vem das luzes amostradas (sem
+    // MIS: o caminho termina aqui) e a indireta, do cache
+    bool diffuse_vertex(path_state& path, const hit_record& rec, const color& attenuation,
+                        const hittable& scene, int remaining) const override {
+        if (path.diffuse_vertices != 2) return false;
+
+        // Difuso: BSDF = attenuation / pi, então a saída indireta é attenuation * E / pi
+        if (!lights.empty())
+            path.L += path.throughput * sample_light(path.current, rec, attenuation, scene, false);
+        path.L += path.throughput * attenuation * irradiance(rec.p, rec.normal, scene, remaining) / pi;
+        return true;
+    }
+
+private:
+    color irradiance(const point3& p, const vec3& n, const hittable& scene, int depth) const {
+        color E;
+        if (depth <= 0) return color(0,0,0);
+        if (cache.lookup(p, n, E)) return E;
+
+        IrradianceRecord record = gather(p, n, scene, depth);
+        cache.insert(record);
+        return record.E;
+    }
+
+    // Amostra o hemisfério em M x N estratos com densidade cos/pi e estima E,
+    // a distância média aos vizinhos e os gradientes (Ward e Heckbert, 1992)
+    IrradianceRecord gather(const point3& p, const vec3& n, const hittable& scene, int depth) const {
+        const int M = theta_strata;
+        const int N = phi_strata;
+
+        // Base ortonormal em torno da normal
+        vec3 a = std::fabs(n.x()) > 0.9 ? vec3(0,1,0) : vec3(1,0,0);
+        vec3 u = unit_vector(cross(a, n));
+        vec3 v = cross(n, u);
+
+        std::vector<color> radiance(M * N);
+        std::vector<double> distance(M * N);
+
+        IrradianceRecord record;
+        record.p = p;
+        record.n = n;
+        color sum(0,0,0);
+        double inverse_distance_sum = 0;
+
+        // Cada raio cobre o ângulo sólido de um estrato (2 pi / M N): é a abertura do seu cone
+        const double spread = std::sqrt(2 * pi / (M * N));
+
+        for (int j = 0; j < M; ++j) {
+            for (int k = 0; k < N; ++k) {
+                double sin2 = (j + random_double()) / M;
+                double sin_theta = std::sqrt(sin2);
+                double cos_theta = std::max(std::sqrt(1 - sin2), 1e-3);
+                double phi = 2 * pi * (k + random_double()) / N;
+                vec3 dir = sin_theta * std::cos(phi) * u + sin_theta * std::sin(phi) * v + cos_theta * n;
+
+                // Luzes amostradas já entram pela NEE de quem consulta o cache
+                double t;
+                color Lk = trace(ray(p, dir, 0, spread), scene, depth, lights.empty(), &t, true);
+                radiance[j * N + k] = Lk;
+                distance[j * N + k] = t;
+                sum += Lk;
+                if (t < infinity) inverse_distance_sum += 1 / t;
+
+                // Rotação: tan(theta) L na direção n x (azimute), o eixo que inclina a normal para a amostra
+                vec3 tangent = -std::sin(phi) * u + std::cos(phi) * v;
+                double tan_theta = sin_theta / cos_theta;
+                for (int c = 0; c < 3; ++c)
+                    record.grad_r[c] += (tan_theta * Lk[c]) * tangent;
+            }
+        }
+
+        const double scale = pi / (M * N);
+        record.E = scale * sum;
+        record.R = inverse_distance_sum > 0 ? (M * N) / inverse_distance_sum : infinity;
+        for (int c = 0; c < 3; ++c) record.grad_r[c] *= scale;
+
+        // Translação: variação de L entre estratos vizinhos, pela menor distância das duas amostras
+        for (int k = 0; k < N; ++k) {
+            double phi_center = 2 * pi * (k + 0.5) / N;
+            double phi_edge = 2 * pi * k / N;
+            vec3 radial = std::cos(phi_center) * u + std::sin(phi_center) * v;
+            vec3 tangent = -std::sin(phi_edge) * u + std::cos(phi_edge) * v;
+            int previous_k = (k + N - 1) % N;
+
+            for (int j = 0; j < M; ++j) {
+                double sin_lower = std::sqrt(double(j) / M);
+                double sin_upper = std::sqrt(double(j + 1) / M);
+                const color& Ljk = radiance[j * N + k];
+
+                if (j > 0) {
+                    double r = std::min(distance[j * N + k], distance[(j - 1) * N + k]);
+                    double coefficient = (2 * pi / N) * sin_lower * (1 - double(j) / M) / r;
+                    color delta = Ljk - radiance[(j - 1) * N + k];
+                    for (int c = 0; c < 3; ++c) record.grad_t[c] += (coefficient * delta[c]) * radial;
+                }
+
+                double r = std::min(distance[j * N + k], distance[j * N + previous_k]);
+                double coefficient = (sin_upper - sin_lower) / r;
+                color delta = Ljk - radiance[j * N + previous_k];
+                for (int c = 0; c < 3; ++c) record.grad_t[c] += (coefficient * delta[c]) * tangent;
+            }
+        }
+
+        return record;
+    }
+
+    IrradianceCache& cache;
+    int theta_strata;
+    int phi_strata;
+};
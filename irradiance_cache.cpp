@@ -0,0 +1,140 @@
+#include "irradiance_cache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+// Registros "à frente" do ponto (d_i < -front_tolerance * R_i) não são usados
+const double front_tolerance = 0.05;
+
+inline int cell_coord(double v, double size) { return static_cast<int>(std::floor(v / size)); }
+
+} // namespace
+
+IrradianceCache::IrradianceCache(double error, double min_spacing, double max_spacing, int bucket_bits)
+    : error(error), min_spacing(min_spacing), max_spacing(std::max(min_spacing, max_spacing))
+{
+    levels = static_cast<int>(std::ceil(std::log2(this->max_spacing / min_spacing))) + 1;
+    bucket_mask = (size_t(1) << bucket_bits) - 1;
+    buckets = std::make_unique<std::atomic<entry*>[]>(bucket_mask + 1);
+    for (size_t b = 0; b <= bucket_mask; ++b)
+        buckets[b].store(nullptr, std::memory_order_relaxed);
+}
+
+IrradianceCache::~IrradianceCache() {
+    for (size_t b = 0; b <= bucket_mask; ++b) {
+        entry* e = buckets[b].load(std::memory_order_relaxed);
+        while (e) {
+            entry* next = e->next;
+            if (e->owner) delete e->record;
+            delete e;
+            e = next;
+        }
+    }
+}
+
+double IrradianceCache::cell_size(int level) const {
+    return std::ldexp(2 * error * min_spacing, level);
+}
+
+size_t IrradianceCache::bucket(int x, int y, int z, int level) const {
+    uint64_t h = uint64_t(uint32_t(x)) * 0x9e3779b97f4a7c15ull;
+    h ^= uint64_t(uint32_t(y)) * 0xc2b2ae3d27d4eb4full;
+    h ^= uint64_t(uint32_t(z)) * 0x165667b19e3779f9ull;
+    h ^= uint64_t(level) * 0x27d4eb2f165667c5ull;
+    h ^= h >> 29;
+    return static_cast<size_t>(h) & bucket_mask;
+}
+
+void IrradianceCache::insert(IrradianceRecord record) {
+    record.R = std::clamp(record.R, min_spacing, max_spacing);
+    const double influence = error * record.R;
+
+    // Limita a extrapolação pelo gradiente a no máximo zerar a irradiância
+    for (int c = 0; c < 3; ++c) {
+        double change = record.grad_t[c].length() * influence;
+        if (change > record.E[c])
+            record.grad_t[c] *= change > 0 ? record.E[c] / change : 0;
+    }
+
+    // Menor nível cuja célula tem o dobro do raio de influência
+    int level = static_cast<int>(std::ceil(std::log2(2 * influence / cell_size(0))));
+    level = std::clamp(level, 0, levels - 1);
+    const double size = cell_size(level);
+
+    const IrradianceRecord* shared = new IrradianceRecord(record);
+    int lo[3], hi[3];
+    for (int a = 0; a < 3; ++a) {
+        lo[a] = cell_coord(record.p[a] - influence, size);
+        hi[a] = cell_coord(record.p[a] + influence, size);
+    }
+
+    bool owner = true;
+    for (int x = lo[0]; x <= hi[0]; ++x)
+    for (int y = lo[1]; y <= hi[1]; ++y)
+    for (int z = lo[2]; z <= hi[2]; ++z) {
+        entry* e = new entry{float(record.p.x()), float(record.p.y()), float(record.p.z()),
+                             float(influence * influence), x, y, z, level, owner, shared, nullptr};
+        owner = false;
+
+        std::atomic<entry*>& head = buckets[bucket(x, y, z, level)];
+        e->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(e->next, e, std::memory_order_release, std::memory_order_relaxed)) {}
+        entries.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    used_levels.fetch_or(1u << level, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool IrradianceCache::lookup(const point3& p, const vec3& n, color& E) const {
+    const double inv_error = 1.0 / error;
+    const float qx = float(p.x()), qy = float(p.y()), qz = float(p.z());
+    double weight_sum = 0;
+    color sum(0, 0, 0);
+
+    for (uint32_t mask = used_levels.load(std::memory_order_relaxed); mask; mask &= mask - 1) {
+        const int level = __builtin_ctz(mask);
+        const double size = cell_size(level);
+
+        const int x = cell_coord(p.x(), size);
+        const int y = cell_coord(p.y(), size);
+        const int z = cell_coord(p.z(), size);
+
+        const entry* e = buckets[bucket(x, y, z, level)].load(std::memory_order_acquire);
+        for (; e; e = e->next) {
+            // Outras células caem no mesmo balde: confere para não contar duas vezes
+            if (e->x != x || e->y != y || e->z != z || e->level != level) continue;
+
+            float dx = qx - e->px, dy = qy - e->py, dz = qz - e->pz;
+            if (dx * dx + dy * dy + dz * dz >= e->influence2) continue;
+
+            const IrradianceRecord& rec = *e->record;
+            vec3 d = p - rec.p;
+            double normal_term = 1 - dot(n, rec.n);
+            double e_i = d.length() / rec.R + std::sqrt(std::max(0.0, normal_term));
+            if (e_i >= error) continue;
+            if (dot(d, 0.5 * (n + rec.n)) < -front_tolerance * rec.R) continue;
+
+            double w = 1 / std::max(e_i, 1e-6) - inv_error;
+            vec3 axis = cross(rec.n, n);
+            color extrapolated(rec.E[0] + dot(d, rec.grad_t[0]) + dot(axis, rec.grad_r[0]),
+                               rec.E[1] + dot(d, rec.grad_t[1]) + dot(axis, rec.grad_r[1]),
+                               rec.E[2] + dot(d, rec.grad_t[2]) + dot(axis, rec.grad_r[2]));
+            sum += w * extrapolated;
+            weight_sum += w;
+        }
+    }
+
+    if (weight_sum <= 0) return false;
+
+    E = sum / weight_sum;
+    E = color(std::max(0.0, E[0]), std::max(0.0, E[1]), std::max(0.0, E[2]));
+    return true;
+}
+
+size_t IrradianceCache::memory_bytes() const {
+    return size() * sizeof(IrradianceRecord) + entries.load(std::memory_order_relaxed) * sizeof(entry) +
+           (bucket_mask + 1) * sizeof(std::atomic<entry*>);
+}
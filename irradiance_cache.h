@@ -0,0 +1,104 @@
+#pragma once
+
+#include "vec3.h"
+#include "color.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @struct IrradianceRecord
+ * @brief Amostra de irradiância num ponto de superfície
+ *
+ * Os gradientes são por canal (r, g, b). O de translação dá a variação de E
+ * ao mover o ponto; o de rotação, ao girar a normal (Ward e Heckbert, 1992).
+ */
+struct IrradianceRecord {
+    point3 p;          // Posição do registro
+    vec3 n;            // Normal no ponto
+    color E;           // Irradiância incidente (sem as luzes amostradas por NEE)
+    double R = 0;      // Média harmônica das distâncias aos objetos vizinhos
+    vec3 grad_t[3];    // dE/dp por canal
+    vec3 grad_r[3];    // dE/dn por canal (eixo de rotação)
+};
+
+/**
+ * @class IrradianceCache
+ * @brief Cache de irradiância para interreflexão difusa
+ *
+ * Os registros ficam numa grade hash multinível. Cada registro vai para o
+ * menor nível cuja célula tem lado de pelo menos o dobro do seu raio de
+ * influência `error * R`, e entra em todas as células (no máximo 8) que a
+ * esfera de influência toca; a busca confere só a célula do ponto em cada
+ * nível ocupado. Cada balde é uma lista ligada com cabeça atômica: inserir é
+ * um CAS na cabeça, e os nós nunca mudam depois de publicados. Assim várias
+ * threads inserem e consultam ao mesmo tempo sem trava global.
+ *
+ * A interpolação usa o peso de Ward com o erro `error` máximo:
+ *   e_i = |p - p_i| / R_i + sqrt(1 - n . n_i),  w_i = 1 / e_i - 1 / error
+ * e extrapola cada registro pelos seus gradientes.
+ */
+class IrradianceCache {
+public:
+    /**
+     * @param error Erro máximo aceito na interpolação (menor = mais registros)
+     * @param min_spacing Menor raio R de um registro (em unidades da cena)
+     * @param max_spacing Maior raio R de um registro
+     * @param bucket_bits Log2 do número de baldes da tabela hash
+     */
+    IrradianceCache(double error = 0.5, double min_spacing = 0.02, double max_spacing = 4.0, int bucket_bits = 16);
+    ~IrradianceCache();
+
+    IrradianceCache(const IrradianceCache&) = delete;
+    IrradianceCache& operator=(const IrradianceCache&) = delete;
+
+    /**
+     * @brief Interpola a irradiância em `p` a partir dos registros vizinhos
+     *
+     * @param p Ponto de consulta
+     * @param n Normal unitária em `p`
+     * @param E Recebe a irradiância interpolada
+     * @return false se nenhum registro cobre o ponto (é preciso criar um)
+     */
+    bool lookup(const point3& p, const vec3& n, color& E) const;
+
+    /**
+     * @brief Adiciona um registro; seguro de chamar de várias threads
+     *
+     * `R` é limitado a [min_spacing, max_spacing] e o gradiente de translação
+     * é reduzido onde extrapolaria a irradiância para valores negativos.
+     */
+    void insert(IrradianceRecord record);
+
+    /// Número de registros inseridos
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+
+    /// Memória usada pelos registros e pela tabela, em bytes
+    size_t memory_bytes() const;
+
+    const double error;
+    const double min_spacing;
+    const double max_spacing;
+
+private:
+    // Posição e raio em float na entrada: a maioria dos candidatos é
+    // descartada sem ler o registro
+    struct entry {
+        float px, py, pz, influence2;  // Posição e (error * R)^2
+        int x, y, z, level;            // Célula desta entrada
+        bool owner;                    // A entrada que libera o registro
+        const IrradianceRecord* record;
+        entry* next;
+    };
+
+    double cell_size(int level) const;
+    size_t bucket(int x, int y, int z, int level) const;
+
+    int levels;
+    size_t bucket_mask;
+    std::unique_ptr<std::atomic<entry*>[]> buckets;
+    std::atomic<uint32_t> used_levels{0}; // Bit k: o nível k tem registros
+    std::atomic<size_t> count{0};
+    std::atomic<size_t> entries{0};
+};
@@ -0,0 +1,63 @@
+#include "light_sampler.h"
+#include "utils.h"
+#include <algorithm>
+
+void LightSampler::add(shared_ptr<hittable> light, double weight) {
+    index_of[light.get()] = lights.size();
+    lights.push_back(light);
+    weights.push_back(weight);
+}
+
+void LightSampler::build() {
+    const size_t n = lights.size();
+    probability.assign(n, 0.0);
+    threshold.assign(n, 1.0);
+    alias.resize(n);
+    if (n == 0) return;
+
+    double total = 0;
+    for (double w : weights) total += w;
+
+    // Escala as probabilidades para média 1 e separa os buckets em pequenos e grandes
+    std::vector<double> scaled(n);
+    std::vector<size_t> small, large;
+    for (size_t i = 0; i < n; ++i) {
+        probability[i] = weights[i] / total;
+        scaled[i] = probability[i] * n;
+        alias[i] = i;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    // Completa cada bucket pequeno com a sobra de um bucket grande
+    while (!small.empty() && !large.empty()) {
+        size_t s = small.back(); small.pop_back();
+        size_t l = large.back(); large.pop_back();
+
+        threshold[s] = scaled[s];
+        alias[s] = l;
+
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        (scaled[l] < 1.0 ? small : large).push_back(l);
+    }
+
+    // O que sobrar (por arredondamento) fica com probabilidade 1
+    for (size_t i : small) threshold[i] = 1.0;
+    for (size_t i : large) threshold[i] = 1.0;
+}
+
+const hittable& LightSampler::sample(double& prob) const {
+    auto u = random_double() * lights.size();
+    size_t bucket = std::min(static_cast<size_t>(u), lights.size() - 1);
+    double frac = u - bucket;
+
+    size_t chosen = (frac < threshold[bucket]) ? bucket : alias[bucket];
+    prob = probability[chosen];
+    return *lights[chosen];
+}
+
+double LightSampler::pdf(const hittable* object, const point3& origin, const vec3& direction) const {
+    auto it = index_of.find(object);
+    if (it == index_of.end()) return 0.0;
+
+    return probability[it->second] * lights[it->second]->pdf_value(origin, direction);
+}
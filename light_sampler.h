@@ -0,0 +1,57 @@
+#pragma once
+
+#include "hittable.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using std::shared_ptr;
+
+/**
+ * @class LightSampler
+ * @brief Escolhe uma fonte de luz entre muitas para a amostragem explícita de luzes
+ *
+ * Cada luz recebe um peso (tipicamente a potência emitida: área vezes radiância)
+ * e a escolha é feita em O(1) por uma tabela de alias (método de Walker/Vose),
+ * independente do número de luzes.
+ *
+ * Uso:
+ *   lights.add(esfera_emissora, peso);
+ *   lights.build();
+ */
+class LightSampler {
+public:
+    /// Adiciona uma fonte de luz com o peso dado
+    void add(shared_ptr<hittable> light, double weight);
+
+    /// Monta a tabela de alias; deve ser chamado após o último `add`
+    void build();
+
+    /// Indica se não há luzes para amostrar
+    bool empty() const { return lights.empty(); }
+
+    /**
+     * @brief Sorteia uma luz
+     * @param probability Recebe a probabilidade da luz escolhida
+     */
+    const hittable& sample(double& probability) const;
+
+    /**
+     * @brief Densidade (por ângulo sólido) de a amostragem de luzes gerar `direction`
+     *        a partir de `origin` atingindo `object`
+     *
+     * @return zero se `object` não for uma das luzes
+     */
+    double pdf(const hittable* object, const point3& origin, const vec3& direction) const;
+
+private:
+    std::vector<shared_ptr<hittable>> lights;
+    std::vector<double> weights;
+    std::vector<double> probability; // Probabilidade de escolha de cada luz
+    std::unordered_map<const hittable*, size_t> index_of;
+
+    // Tabela de alias: o bucket i fica com a luz i com chance `threshold[i]`,
+    // senão com a luz `alias[i]`
+    std::vector<double> threshold;
+    std::vector<size_t> alias;
+};
@@ -1,38 +1,190 @@
 #include "utils.h"
 #include "renderer.h"
 #include "hittable_list.h"
-#include "sphere.h"
-#include "material.h" // Importante: inclui lambertian, metal, etc.
+#include "bvh.h"
+#include "wide_bvh.h"
+#include "scenes.h"
+#include "light_sampler.h"
+#include "animation.h"
 #include "camera.h"   // Sua classe camera extraída
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
-int main() {
+/**
+ * @brief Grava o acúmulo como PPM (P3), convertido pelo mesmo resolve da janela
+ */
+static void save_ppm(const std::string& path, const AccumulationBuffer& image, Tonemap op) {
+    std::vector<uint32_t> pixels(static_cast<size_t>(image.width) * image.height);
+    resolve(image, op, 1, pixels.data(), 0);
+
+    std::ofstream out(path);
+    out << "P3\n" << image.width << ' ' << image.height << "\n255\n";
+    for (uint32_t p : pixels)
+        out << ((p >> 16) & 0xff) << ' ' << ((p >> 8) & 0xff) << ' ' << (p & 0xff) << '\n';
+}
+
+int main(int argc, char** argv) {
     // 1. Configurações
     RenderSettings settings;
     settings.image_width = 800;
     settings.samples_per_pixel = 20;
     settings.max_depth = 50;
-    
-    // 2. Cena
-    hittable_list world;
 
-    // Instanciação direta (sem Factory)
-    auto mat_ground = make_shared<lambertian>(color(0.8, 0.8, 0.0));
-    auto mat_center = make_shared<lambertian>(color(0.1, 0.2, 0.5));
-    auto mat_left   = make_shared<metal>(color(0.8, 0.8, 0.8), 0.3);
-    auto mat_right  = make_shared<metal>(color(0.8, 0.6, 0.2), 0.0);
+    // Argumentos:
+    //   --lights             cena com 1000 esferas emissoras, sem céu
+    //   --checkpoint <file>  grava o acúmulo periodicamente e retoma dele ao reiniciar
+    //   --wide-bvh           usa a BVH de 8 filhos quantizada no lugar da binária
+    //   --target-ms <ms>     ajusta a qualidade de cada quadro para caber nesse tempo
+    //   --output <file.ppm>  renderiza sem janela (Renderer::submit) e grava a imagem
+    //   --tonemap <op>       gamma2 (padrão), srgb ou aces
+    //   --diffuse            sala fechada só com materiais difusos, sem céu
+    //   --irradiance-cache   interpola a luz indireta difusa de um cache de irradiância
+    //   --reorder-rays       traça cada tile em lote, com os raios secundários ordenados
+    //   --packets            traça os raios primários em pacotes 8x8 com frustum
+    //   --textures <dir>     esferas com texturas de imagem lidas sob demanda de <dir>
+    //   --texture-cache-mb <mb>  memória do cache de tiles das texturas (padrão 256)
+    //   --serve <porta>      sem janela: transmite os quadros para o rtviewer por TCP
+    //   --animate <arquivo>  renderiza uma animação com a câmera nos quadros-chave do
+    //                        arquivo (`<quadro> <x> <y> <z>` por linha), gravando em
+    //                        --output (padrão quadro_%04d.ppm: um único %d, %% para %;
+    //                        `.pfm` grava float)
+    //   --frames <n>         quadros da animação (padrão: até o último quadro-chave)
+    //   --first-frame <k>    primeiro quadro da animação (padrão 0)
+    //   --spp <n>            amostras por pixel (padrão 20)
+    //   --spheres <n>        campo com n esferas pequenas, em vetores contíguos (`flat_scene`)
+    bool many_lights = false;
+    bool diffuse = false;
+    bool use_cache = false;
+    bool wide = false;
+    std::string output_path;
+    std::string texture_dir;
+    double texture_cache_mb = 256;
+    int serve_port = 0;
+    std::string animation_path;
+    int frame_count = -1;
+    int first_frame = 0;
+    long long sphere_count = 0;
+    for (int k = 1; k < argc; ++k) {
+        std::string arg = argv[k];
+        if (arg == "--lights")
+            many_lights = true;
+        else if (arg == "--checkpoint" && k + 1 < argc)
+            settings.checkpoint_path = argv[++k];
+        else if (arg == "--wide-bvh")
+            wide = true;
+        else if (arg == "--target-ms" && k + 1 < argc)
+            settings.target_frame_ms = std::stod(argv[++k]);
+        else if (arg == "--output" && k + 1 < argc)
+            output_path = argv[++k];
+        else if (arg == "--diffuse")
+            diffuse = true;
+        else if (arg == "--irradiance-cache")
+            use_cache = true;
+        else if (arg == "--reorder-rays")
+            settings.reorder_rays = true;
+        else if (arg == "--packets")
+            settings.primary_packets = true;
+        else if (arg == "--textures" && k + 1 < argc)
+            texture_dir = argv[++k];
+        else if (arg == "--texture-cache-mb" && k + 1 < argc)
+            texture_cache_mb = std::stod(argv[++k]);
+        else if (arg == "--serve" && k + 1 < argc)
+            serve_port = std::stoi(argv[++k]);
+        else if (arg == "--animate" && k + 1 < argc)
+            animation_path = argv[++k];
+        else if (arg == "--frames" && k + 1 < argc)
+            frame_count = std::stoi(argv[++k]);
+        else if (arg == "--first-frame" && k + 1 < argc)
+            first_frame = std::stoi(argv[++k]);
+        else if (arg == "--spheres" && k + 1 < argc)
+            sphere_count = std::stoll(argv[++k]);
+        else if (arg == "--spp" && k + 1 < argc)
+            settings.samples_per_pixel = std::stoi(argv[++k]);
+        else if (arg == "--tonemap" && k + 1 < argc) {
+            std::string op = argv[++k];
+            settings.tonemap = op == "aces" ? Tonemap::ACES : op == "srgb" ? Tonemap::SRGB : Tonemap::Gamma2;
+        }
+    }
 
-    world.add(make_shared<sphere>(point3( 0.0, -100.5, -1.0), 100.0, mat_ground));
-    world.add(make_shared<sphere>(point3( 0.0,    0.0, -1.0),   0.5, mat_center));
-    world.add(make_shared<sphere>(point3(-1.0,    0.0, -1.0),   0.5, mat_left));
-    world.add(make_shared<sphere>(point3( 1.0,    0.0, -1.0),   0.5, mat_right));
+    CameraPath camera_path;
+    if (!animation_path.empty() && !camera_path.load(animation_path))
+        return 1;
+
+    // 2. Cena
+    hittable_list world;
+    LightSampler lights;
+    TileCache tiles(static_cast<size_t>(texture_cache_mb * 1e6));
+    if (!texture_dir.empty()) {
+        if (!textured_scene(world, tiles, texture_dir)) {
+            std::fprintf(stderr, "Não foi possível preparar as texturas em %s\n", texture_dir.c_str());
+            return 1;
+        }
+    } else if (sphere_count > 0)
+        sphere_field_scene(world, static_cast<size_t>(sphere_count));
+    else if (many_lights)
+        many_lights_scene(world, lights);
+    else if (diffuse)
+        diffuse_scene(world, lights);
+    else
+        default_scene(world);
+    bvh tree(world.objects);
+    std::unique_ptr<wide_bvh> wide_tree;
+    if (wide) wide_tree = std::make_unique<wide_bvh>(tree);
+    const hittable& scene = wide_tree ? static_cast<const hittable&>(*wide_tree) : tree;
 
     // 3. Câmera e Integrador
-    camera cam; 
-    RecursiveIntegrator integrator(settings.max_depth);
+    camera cam;
+    IrradianceCache cache;
+    std::unique_ptr<PathIntegrator> integrator;
+    if (use_cache)
+        integrator = std::make_unique<IrradianceCacheIntegrator>(settings.max_depth, lights, cache);
+    else
+        integrator = std::make_unique<PathIntegrator>(settings.max_depth, lights);
+    integrator->sky = !many_lights && !diffuse;
 
-    // 4. Execução (Janela Gráfica)
+    // 4. Execução (Janela Gráfica, ou job assíncrono sem janela)
     Renderer engine(settings);
-    engine.render(world, cam, integrator);
+    if (serve_port > 0) {
+        engine.serve(scene, cam, *integrator, serve_port);
+        return 1; // serve só retorna se a porta não abrir
+    }
+    if (!animation_path.empty()) {
+        // A cena, a BVH e os caches são construídos uma vez para todos os quadros
+        if (frame_count < 0)
+            frame_count = static_cast<int>(camera_path.last_frame()) + 1 - first_frame;
+        AnimationStats stats = render_animation(engine, scene, cam, *integrator, settings, camera_path,
+                                                first_frame, frame_count,
+                                                output_path.empty() ? "quadro_%04d.ppm" : output_path);
+        if (stats.frames > 0)
+            std::printf("%d quadros em %.2f s (render %.2f s, %.2f s esperando a gravação)\n",
+                        stats.frames, stats.total, stats.render, stats.stalled);
+        return stats.failed ? 1 : 0;
+    }
+    if (output_path.empty()) {
+        engine.render(scene, cam, *integrator);
+        return 0;
+    }
+
+    RenderJob job = engine.submit(scene, cam, *integrator, settings);
+    while (!job.done()) {
+        std::printf("\rRenderizando: %5.1f%%", 100 * job.progress());
+        std::fflush(stdout);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    std::printf("\rRenderizando: 100.0%%\n");
+    save_ppm(output_path, job.result().image, settings.tonemap);
+    if (use_cache)
+        std::printf("Cache de irradiância: %zu registros, %.1f MB\n", cache.size(), cache.memory_bytes() / 1e6);
+    if (!texture_dir.empty()) {
+        TileCacheStats stats = tiles.stats();
+        std::printf("Cache de texturas: %.1f%% de acertos, %.1f MB lidos do disco, %.1f MB em memória\n",
+                    100 * stats.hit_rate(), stats.bytes_loaded / 1e6, stats.bytes_resident / 1e6);
+    }
 
     return 0;
-}
\ No newline at end of file
+}
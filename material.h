@@ -1,7 +1,11 @@
 #pragma once
 
 #include "utils.h"
+#include "color.h"
 #include "hittable.h" // Precisa conhecer hit_record
+#include "texture.h"
+#include <algorithm>
+#include <memory>
 
 struct hit_record;
 
@@ -11,11 +15,33 @@ class material {
         virtual bool scatter(
             const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered
         ) const = 0;
+
+        // Luz emitida pela superfície (zero para materiais que não emitem)
+        virtual color emitted(const ray& r_in, const hit_record& rec) const {
+            return color(0, 0, 0);
+        }
+
+        // Densidade (por ângulo sólido) com que `scatter` gera a direção de `scattered`.
+        // Zero indica um material especular (delta), que não recebe amostragem de luzes.
+        // Para materiais não especulares, `attenuation * scattering_pdf` é o BSDF vezes o cosseno.
+        virtual double scattering_pdf(
+            const ray& r_in, const hit_record& rec, const ray& scattered
+        ) const {
+            return 0;
+        }
+
+        virtual ~material() = default;
 };
 
+// Depois de uma rebatida difusa o cone do raio abre pelo menos até este
+// ângulo: o que é visto por reflexos difusos usa níveis de mip grosseiros
+// (mais baratos de carregar), já que o ruído da amostragem esconde os detalhes
+const double diffuse_spread = 0.1;
+
 class lambertian : public material {
     public:
         lambertian(const color& a) : albedo(a) {}
+        lambertian(std::shared_ptr<texture> t) : albedo(1, 1, 1), albedo_texture(std::move(t)) {}
 
         virtual bool scatter(
             const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered
@@ -26,30 +52,63 @@ class lambertian : public material {
             if (scatter_direction.near_zero())
                 scatter_direction = rec.normal;
 
-            scattered = ray(rec.p, scatter_direction);
-            attenuation = albedo; // A cor do objeto (ex: vermelho absorve verde e azul)
+            scattered = ray(rec.p, scatter_direction, r_in.footprint(rec.t), std::max(r_in.spread(), diffuse_spread));
+            // A cor do objeto (ex: vermelho absorve verde e azul)
+            attenuation = albedo_texture ? texture_value(*albedo_texture, r_in, rec) : albedo;
             return true;
         }
 
+        // normal + vetor unitário aleatório gera direções com densidade cos(theta) / pi
+        virtual double scattering_pdf(
+            const ray& r_in, const hit_record& rec, const ray& scattered
+        ) const override {
+            auto cos_theta = dot(rec.normal, unit_vector(scattered.direction()));
+            return cos_theta < 0 ? 0 : cos_theta / pi;
+        }
+
     public:
         color albedo; // Cor base
+        std::shared_ptr<texture> albedo_texture; // Substitui `albedo` se existir
 };
 
 class metal : public material {
     public:
         metal(const color& a, double f) : albedo(a), fuzz(f < 1 ? f : 1) {}
+        metal(std::shared_ptr<texture> t, double f) : albedo(1, 1, 1), albedo_texture(std::move(t)), fuzz(f < 1 ? f : 1) {}
 
         virtual bool scatter(
             const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered
         ) const override {
             vec3 reflected = reflect(unit_vector(r_in.direction()), rec.normal);
             // O fuzz adiciona um pouco de aleatoriedade no reflexo (metal fosco)
-            scattered = ray(rec.p, reflected + fuzz*random_in_unit_sphere());
-            attenuation = albedo;
+            // e abre o cone do raio na mesma medida
+            scattered = ray(rec.p, reflected + fuzz*random_in_unit_sphere(), r_in.footprint(rec.t), r_in.spread() + fuzz);
+            attenuation = albedo_texture ? texture_value(*albedo_texture, r_in, rec) : albedo;
             return (dot(scattered.direction(), rec.normal) > 0);
         }
 
     public:
         color albedo;
+        std::shared_ptr<texture> albedo_texture; // Substitui `albedo` se existir
         double fuzz;
+};
+
+class diffuse_light : public material {
+    public:
+        diffuse_light(const color& c) : emit(c) {}
+
+        // Luzes não espalham: o caminho termina nelas
+        virtual bool scatter(
+            const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered
+        ) const override {
+            return false;
+        }
+
+        // Emite apenas pelo lado de fora da superfície
+        virtual color emitted(const ray& r_in, const hit_record& rec) const override {
+            return rec.front_face ? emit : color(0, 0, 0);
+        }
+
+    public:
+        color emit; // Radiância emitida
 };
\ No newline at end of file
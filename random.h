@@ -0,0 +1,84 @@
+/**
+ * @file random.h
+ * @brief Gerador de números aleatórios (PCG32) com estado explícito.
+ *
+ * Substitui `rand()`: o estado é por thread e pode ser semeado a partir de
+ * (semente global, pixel, índice da amostra). Assim cada amostra tem sempre a
+ * mesma sequência aleatória, o que permite retomar um render salvo em
+ * checkpoint exatamente de onde parou.
+ */
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+/**
+ * @brief Estado do gerador da thread atual
+ */
+inline uint64_t& random_state() {
+    static thread_local uint64_t state = 0x853c49e6748fea9bULL;
+    return state;
+}
+
+/**
+ * @brief Mistura bits de um inteiro de 64 bits (finalizador do SplitMix64)
+ */
+inline uint64_t mix_bits(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Reinicia o gerador da thread atual
+ */
+inline void seed_random(uint64_t seed) {
+    random_state() = mix_bits(seed);
+}
+
+/**
+ * @brief Semente da amostra `sample` do pixel `pixel`
+ *
+ * @param seed Semente global do render
+ * @param pixel Índice linear do pixel
+ * @param sample Índice da amostra dentro do pixel
+ */
+inline uint64_t sample_seed(uint64_t seed, uint64_t pixel, uint64_t sample) {
+    return mix_bits(seed ^ mix_bits(pixel ^ mix_bits(sample)));
+}
+
+/**
+ * @brief Próximo inteiro de 32 bits (PCG-XSH-RR)
+ */
+inline uint32_t random_uint32() {
+    uint64_t old = random_state();
+    random_state() = old * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = static_cast<uint32_t>(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+/**
+ * @brief Gera um número real aleatório no intervalo [0, 1)
+ *
+ * @return Número aleatório entre 0 (inclusive) e 1 (exclusive).
+ */
+inline double random_double() {
+    return random_uint32() * (1.0 / 4294967296.0);
+}
+
+/**
+ * @brief Gera um número real aleatório no intervalo [min, max)
+ *
+ * @param min Limite inferior
+ * @param max Limite superior
+ * @return Número aleatório entre `min` (inclusive) e `max` (exclusive)
+ */
+inline double random_double(double min, double max) {
+    return min + (max-min)*random_double();
+}
+
+#endif
@@ -10,6 +10,10 @@
  * Um raio é definido por:
  * - um ponto de origem (`orig`)
  * - um vetor de direção (`dir`)
+ *
+ * e carrega também a pegada do raio como um cone (uma diferencial de raio
+ * isotrópica): largura `width` na origem, que cresce `spread` por unidade
+ * de distância. Texturas usam a pegada para escolher o nível de mip.
  */
 class ray {
   public:
@@ -25,6 +29,14 @@ class ray {
      */
     ray(const point3& origin, const vec3& direction) : orig(origin), dir(direction) {}
 
+    /**
+     * @brief Construtor com a pegada do raio
+     * @param width Largura da pegada na origem
+     * @param spread Ângulo de abertura do cone, em radianos
+     */
+    ray(const point3& origin, const vec3& direction, double width, double spread)
+        : orig(origin), dir(direction), cone_width(width), cone_spread(spread) {}
+
     /**
      * @brief Retorna a origem do raio.
      */
@@ -45,9 +57,24 @@ class ray {
         return orig + t*dir;
     }
 
+    /**
+     * @brief Largura da pegada do raio no parâmetro t (0 se o raio não tem cone)
+     */
+    double footprint(double t) const {
+        if (cone_spread == 0) return cone_width;
+        return cone_width + t * dir.length() * cone_spread;
+    }
+
+    /**
+     * @brief Ângulo de abertura do cone do raio
+     */
+    double spread() const { return cone_spread; }
+
   private:
     point3 orig;
     vec3 dir;
+    double cone_width = 0;
+    double cone_spread = 0;
 };
 
 #endif
@@ -0,0 +1,105 @@
+#include "ray_batch.h"
+#include "aabb.h"
+#include <algorithm>
+
+namespace {
+
+const int cell_bits = 9; // Bits por eixo da célula da origem
+const int key_bits = 3 * cell_bits + 3;
+
+// Com um número par de passadas o radix sort termina em `keys`/`order`
+static_assert((key_bits + 7) / 8 % 2 == 0, "o radix sort precisa de um número par de passadas");
+
+/// Espalha os 9 bits baixos de v para as posições 0, 3, 6, ...
+inline uint32_t spread_bits(uint32_t v) {
+    v &= 0x1ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v << 8)) & 0x0300f00f;
+    v = (v | (v << 4)) & 0x030c30c3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
+}
+
+inline uint32_t ray_key(const ray& r, const point3& origin_min, const vec3& cell_scale) {
+    const vec3& d = r.direction();
+    uint32_t octant = (d.x() < 0 ? 1u : 0u) | (d.y() < 0 ? 2u : 0u) | (d.z() < 0 ? 4u : 0u);
+
+    const uint32_t max_cell = (1u << cell_bits) - 1;
+    uint32_t cell[3];
+    for (int a = 0; a < 3; ++a) {
+        double c = (r.origin()[a] - origin_min[a]) * cell_scale[a];
+        cell[a] = std::min(max_cell, static_cast<uint32_t>(std::max(0.0, c)));
+    }
+
+    uint32_t morton = spread_bits(cell[0]) | (spread_bits(cell[1]) << 1) | (spread_bits(cell[2]) << 2);
+    return (octant << (3 * cell_bits)) | morton;
+}
+
+} // namespace
+
+void sort_rays(RayBatch& batch) {
+    std::vector<uint32_t>& order = batch.order;
+    const size_t n = order.size();
+    if (n < 2) return;
+
+    aabb bounds;
+    for (uint32_t k : order) bounds.expand(batch.rays[k].origin());
+
+    vec3 cell_scale;
+    for (int a = 0; a < 3; ++a) {
+        double extent = bounds.max()[a] - bounds.min()[a];
+        cell_scale[a] = extent > 0 ? (1 << cell_bits) / extent : 0;
+    }
+
+    std::vector<uint32_t>& keys = batch.keys;
+    keys.resize(n);
+    for (size_t k = 0; k < n; ++k)
+        keys[k] = ray_key(batch.rays[order[k]], bounds.min(), cell_scale);
+
+    // Radix sort LSD: cada passada ordena por 8 bits, levando junto o índice
+    std::vector<uint32_t>& scratch = batch.scratch;
+    scratch.resize(2 * n);
+    uint32_t* src_key = keys.data();
+    uint32_t* src_idx = order.data();
+    uint32_t* dst_key = scratch.data();
+    uint32_t* dst_idx = scratch.data() + n;
+
+    for (int shift = 0; shift < key_bits; shift += 8) {
+        size_t count[257] = {};
+        for (size_t k = 0; k < n; ++k) count[((src_key[k] >> shift) & 0xff) + 1]++;
+        for (int b = 0; b < 256; ++b) count[b + 1] += count[b];
+
+        for (size_t k = 0; k < n; ++k) {
+            size_t slot = count[(src_key[k] >> shift) & 0xff]++;
+            dst_key[slot] = src_key[k];
+            dst_idx[slot] = src_idx[k];
+        }
+        std::swap(src_key, dst_key);
+        std::swap(src_idx, dst_idx);
+    }
+}
+
+void intersect_packets(RayBatch& batch, const hittable& scene, double t_min, double t_max) {
+    ray rays[ray_packet::max_size];
+    hit_record recs[ray_packet::max_size];
+    const std::vector<uint32_t>& order = batch.order;
+
+    for (size_t begin = 0; begin < order.size();) {
+        const point3& origin = batch.rays[order[begin]].origin();
+        int count = 0;
+        while (count < ray_packet::max_size && begin + count < order.size()) {
+            const ray& r = batch.rays[order[begin + count]];
+            if (r.origin().x() != origin.x() || r.origin().y() != origin.y() || r.origin().z() != origin.z())
+                break;
+            rays[count++] = r;
+        }
+
+        uint64_t mask = scene.hit_packet(ray_packet(rays, count), t_min, t_max, recs);
+        for (int k = 0; k < count; ++k) {
+            uint32_t path = order[begin + k];
+            batch.found[path] = (mask >> k) & 1;
+            if (batch.found[path]) batch.hits[path] = recs[k];
+        }
+        begin += count;
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ray.h"
+#include "color.h"
+#include "hittable.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct RayBatch
+ * @brief Lote de caminhos traçados juntos por `Integrator::Li_batch`
+ *
+ * Cada raio leva o estado do gerador aleatório do seu caminho: o lote pode
+ * intercalar os caminhos em qualquer ordem e ainda assim cada amostra usa a
+ * mesma sequência aleatória que teria em `Li`. Os vetores `order`, `hits`,
+ * `keys` e `scratch` são áreas de trabalho reaproveitadas entre lotes.
+ */
+struct RayBatch {
+    std::vector<ray> rays;          // Raio atual de cada caminho
+    std::vector<uint64_t> rng;      // Estado do gerador de cada caminho
+    std::vector<color> radiance;    // Resultado de cada caminho
+
+    std::vector<uint32_t> order;    // Caminhos ativos, na ordem de travessia
+    std::vector<hit_record> hits;
+    std::vector<uint8_t> found;
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> scratch;
+
+    // Traça o primeiro hit em pacotes (`intersect_packets`)
+    bool packets = false;
+
+    size_t size() const { return rays.size(); }
+
+    void clear() {
+        rays.clear();
+        rng.clear();
+        radiance.clear();
+    }
+
+    /// Adiciona um caminho que começa em `r` com o gerador no estado `rng_state`
+    void add(const ray& r, uint64_t rng_state) {
+        rays.push_back(r);
+        rng.push_back(rng_state);
+        radiance.push_back(color(0,0,0));
+    }
+};
+
+/**
+ * @brief Reordena `batch.order` para que raios parecidos fiquem juntos
+ *
+ * A chave de cada raio é o octante da direção (3 bits, os mais altos)
+ * seguido do código de Morton da origem quantizada numa grade 512^3 sobre a
+ * caixa das origens do lote. Raios que saem da mesma região na mesma
+ * direção geral percorrem os mesmos nós da BVH em sequência, e esses nós
+ * continuam no cache. A ordenação é um radix sort estável de 8 bits por
+ * passada.
+ */
+void sort_rays(RayBatch& batch);
+
+/**
+ * @brief Primeiro hit dos caminhos de `batch.order` com `hittable::hit_packet`
+ *
+ * Raios consecutivos de `order` com a mesma origem (os primários de uma
+ * câmera pinhole) formam pacotes de até 64; preenche `hits` e `found` como
+ * `scene.hit` faria raio a raio.
+ */
+void intersect_packets(RayBatch& batch, const hittable& scene, double t_min, double t_max);
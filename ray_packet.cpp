@@ -0,0 +1,77 @@
+#include "ray_packet.h"
+#include <algorithm>
+#include <cmath>
+
+ray_packet::ray_packet(const ray* source, int n)
+    : origin(source[0].origin()), count(std::clamp(n, 1, max_size)), rays(source)
+{
+    // Os raios da câmera têm comprimentos parecidos: a soma das direções
+    // basta para escolher o eixo dominante
+    vec3 mean(0, 0, 0);
+    for (int k = 0; k < max_size; ++k) {
+        if (k < count) {
+            const vec3& d = rays[k].direction();
+            inv_x[k] = static_cast<float>(1 / d.x());
+            inv_y[k] = static_cast<float>(1 / d.y());
+            inv_z[k] = static_cast<float>(1 / d.z());
+            mean += d;
+        } else {
+            inv_x[k] = inv_y[k] = inv_z[k] = 0;
+        }
+    }
+
+    // Eixo dominante: todas as direções precisam ter o mesmo sinal nele
+    int axis = 0;
+    for (int a = 1; a < 3; ++a)
+        if (std::fabs(mean[a]) > std::fabs(mean[axis])) axis = a;
+    const double sign = mean[axis] < 0 ? -1 : 1;
+    const int a = (axis + 1) % 3;
+    const int b = (axis + 2) % 3;
+    const float* inv_axis = axis == 0 ? inv_x : axis == 1 ? inv_y : inv_z;
+
+    // Limites da projeção x_a / x_axis e x_b / x_axis
+    double lo_a = infinity, hi_a = -infinity, lo_b = infinity, hi_b = -infinity;
+    for (int k = 0; k < count; ++k) {
+        const vec3& d = rays[k].direction();
+        if (d[axis] * sign <= 0) return;
+        double pa = d[a] * inv_axis[k];
+        double pb = d[b] * inv_axis[k];
+        lo_a = std::min(lo_a, pa);
+        hi_a = std::max(hi_a, pa);
+        lo_b = std::min(lo_b, pb);
+        hi_b = std::max(hi_b, pb);
+    }
+
+    // Folga para raios na borda (o inverso em float erra até ~6e-8)
+    const double slack = 1e-6;
+    lo_a -= slack * (1 + std::fabs(lo_a));
+    hi_a += slack * (1 + std::fabs(hi_a));
+    lo_b -= slack * (1 + std::fabs(lo_b));
+    hi_b += slack * (1 + std::fabs(hi_b));
+
+    // x_a - lo * x_axis >= 0 (com o sinal do eixo) e hi * x_axis - x_a >= 0
+    auto plane = [&](int other, double slope, double side) {
+        vec3 n(0, 0, 0);
+        n[other] = side * sign;
+        n[axis] = -side * slope * sign;
+        return n;
+    };
+    planes[0] = plane(a, lo_a, 1);
+    planes[1] = plane(a, hi_a, -1);
+    planes[2] = plane(b, lo_b, 1);
+    planes[3] = plane(b, hi_b, -1);
+    has_frustum = true;
+}
+
+bool ray_packet::culls(const aabb& box) const {
+    if (!has_frustum) return false;
+
+    for (const vec3& n : planes) {
+        // Vértice da caixa mais à frente do plano
+        double distance = 0;
+        for (int a = 0; a < 3; ++a)
+            distance += n[a] * ((n[a] > 0 ? box.max()[a] : box.min()[a]) - origin[a]);
+        if (distance < 0) return true;
+    }
+    return false;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ray.h"
+#include "aabb.h"
+#include <cstdint>
+
+/**
+ * @struct ray_packet
+ * @brief Até 64 raios com a mesma origem (ex.: 8x8 pixels de um tile), traçados juntos
+ *
+ * Aponta para os raios originais (para os testes com os objetos, em double) e
+ * guarda os inversos das direções em float, em estrutura de vetores, para testar 8
+ * raios contra uma caixa de uma vez.
+ *
+ * O frustum é a pirâmide com vértice na origem que contém todos os raios:
+ * os raios são projetados no plano perpendicular ao eixo dominante, e os 4
+ * planos passam pelos limites dessa projeção. Uma caixa inteira fora de um
+ * dos planos não é atingida por nenhum raio do pacote. Se as direções não
+ * cabem num mesmo semiespaço do eixo dominante, o pacote fica sem frustum.
+ */
+struct ray_packet {
+    static constexpr int max_size = 64;
+
+    /// Todos os raios devem sair de `rays[0].origin()`; `count` de 1 a 64. Os
+    /// raios não são copiados: `rays` precisa existir enquanto o pacote for usado
+    ray_packet(const ray* rays, int count);
+
+    /// Máscara com um bit ligado para cada raio do pacote
+    uint64_t all() const { return count == max_size ? ~uint64_t(0) : (uint64_t(1) << count) - 1; }
+
+    /// A caixa está inteira fora do frustum
+    bool culls(const aabb& box) const;
+
+    point3 origin;
+    int count;
+    const ray* rays;
+
+    alignas(32) float inv_x[max_size];
+    alignas(32) float inv_y[max_size];
+    alignas(32) float inv_z[max_size];
+
+    // Um ponto x está dentro do frustum se dot(planes[k], x - origin) >= 0 nos 4
+    vec3 planes[4];
+    bool has_frustum = false;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "accumulation.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+
+/**
+ * @struct RenderResult
+ * @brief Resultado de um job de render
+ */
+struct RenderResult {
+    AccumulationBuffer image; // Soma das amostras por pixel (divida por `count`)
+    bool cancelled = false;   // O job parou antes de completar as amostras
+    uint64_t samples = 0;     // Amostras feitas
+};
+
+/**
+ * @class RenderJob
+ * @brief Handle de um render assíncrono criado por `Renderer::submit`
+ *
+ * O handle é barato de copiar; todas as cópias veem o mesmo job. O
+ * cancelamento é cooperativo: as threads de render conferem o pedido antes
+ * de cada tile, então o job para depois de no máximo um tile por thread.
+ * O `result()` de um job cancelado traz o que foi acumulado até ali.
+ */
+class RenderJob {
+public:
+    RenderJob() = default;
+
+    /// `false` para um handle vazio (construído por padrão)
+    bool valid() const { return state != nullptr; }
+
+    /// Pede o cancelamento do job
+    void cancel() { state->cancel = true; }
+
+    /// O cancelamento foi pedido
+    bool cancel_requested() const { return state->cancel; }
+
+    /// Fração das amostras já feitas (0 a 1)
+    double progress() const {
+        return state->samples_total ? double(state->samples_done) / state->samples_total : 1.0;
+    }
+
+    /// O job terminou (completo ou cancelado)
+    bool done() const { return result_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+
+    /// Bloqueia até o job terminar
+    void wait() const { result_future.wait(); }
+
+    /// Resultado do job; bloqueia até ele terminar
+    const RenderResult& result() const { return result_future.get(); }
+
+    /// Future do resultado, para compor com outros mecanismos de espera
+    const std::shared_future<RenderResult>& future() const { return result_future; }
+
+private:
+    friend class Renderer;
+
+    // Compartilhado entre os handles e a thread do job
+    struct State {
+        std::atomic<bool> cancel{false};
+        std::atomic<uint64_t> samples_done{0};
+        uint64_t samples_total = 0;
+    };
+
+    std::shared_ptr<State> state;
+    std::shared_future<RenderResult> result_future;
+};
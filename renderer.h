@@ -1,9 +1,30 @@
 #pragma once
 #include "window.h"
+#include "frame_stream.h"
 #include "integrator.h"
 #include "camera.h"
 #include "hittable.h"
+#include "accumulation.h"
+#include "reprojection.h"
+#include "checkpoint.h"
+#include "tiles.h"
+#include "frame_budget.h"
+#include "render_job.h"
+#include "resolve.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <future>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 // 1. A struct TEM que vir antes da classe
 struct RenderSettings {
@@ -11,54 +32,521 @@ struct RenderSettings {
     double aspect_ratio = 16.0 / 9.0;
     int samples_per_pixel = 50;
     int max_depth = 50;
+
+    // Amostras por pixel em cada passada sobre a imagem (a imagem refina progressivamente)
+    int samples_per_pass = 4;
+    // Lado dos tiles de trabalho, em pixels (potência de 2)
+    int tile_size = 8;
+    // Ordem em que os tiles são entregues às threads
+    TileOrder tile_order = TileOrder::Morton;
+    // Threads de render (0 = uma por núcleo)
+    int threads = 0;
+    // Traça as amostras de cada tile em lote, uma rebatida por vez, ordenando
+    // os raios secundários por direção e origem (`Integrator::Li_batch`)
+    bool reorder_rays = false;
+    // Traça os raios primários de cada tile em pacotes de até 64 com frustum
+    // (`bvh::hit_packet`); também usa o lote de `Integrator::Li_batch`
+    bool primary_packets = false;
+
+    // Reaproveita as amostras já acumuladas quando a câmera se move
+    bool temporal_reprojection = true;
+    // Diferença relativa de profundidade aceita antes de descartar o histórico
+    double reprojection_depth_tolerance = 0.05;
+
+    // Semente global: cada amostra usa a sequência aleatória derivada de (seed, pixel, amostra)
+    uint64_t seed = 0;
+
+    // Checkpoint periódico do acúmulo (desligado se o caminho for vazio)
+    std::string checkpoint_path;
+    double checkpoint_interval = 30.0; // segundos
+
+    // Tempo de quadro desejado, em ms (0 = desligado). Ligado, cada passada é um
+    // quadro: amostras e resolução interna são ajustadas para caber nele (a profundidade não muda)
+    double target_frame_ms = 0;
+
+    // Conversão do acúmulo para 8 bits na tela
+    Tonemap tonemap = Tonemap::Gamma2;
 };
 
 // 2. A classe Renderer vem depois
 class Renderer {
 public:
-    Renderer(const RenderSettings& settings) 
-        : settings(settings), 
-          window(settings.image_width, static_cast<int>(settings.image_width / settings.aspect_ratio)) 
+    Renderer(const RenderSettings& settings)
+        : settings(settings),
+          image_height(static_cast<int>(settings.image_width / settings.aspect_ratio)),
+          accumulation(settings.image_width, image_height, settings.tile_size, settings.tile_order),
+          history(settings.image_width, image_height, settings.tile_size, settings.tile_order)
     {
-        image_height = static_cast<int>(settings.image_width / settings.aspect_ratio);
+        if (!settings.checkpoint_path.empty())
+            checkpoint = std::make_unique<CheckpointWriter>(settings.checkpoint_path, settings.image_width, image_height);
+        if (settings.target_frame_ms > 0)
+            budget = std::make_unique<FrameBudget>(settings.target_frame_ms, settings.samples_per_pass, settings.max_depth);
+    }
+
+    /// Cancela os jobs em andamento e espera por eles
+    ~Renderer() {
+        for (RunningJob& job : jobs) {
+            job.state->cancel = true;
+            job.thread.join();
+        }
     }
 
+    /**
+     * @brief Render interativo: abre a janela e só retorna quando ela é fechada
+     */
     void render(const hittable& scene, camera& cam, const Integrator& integrator) {
-        while (!window.should_close()) {
-            for (int j = image_height - 1; j >= 0; --j) {
-                
+        if (!display) display = std::make_unique<Window>(settings.image_width, image_height);
+        interactive(scene, cam, integrator);
+    }
+
+    /**
+     * @brief Render interativo sem janela, transmitido para um visualizador remoto
+     *
+     * Igual a `render`, mas as imagens vão por TCP (`FrameStreamer`) e o
+     * input da câmera vem do visualizador. Só retorna se a porta não abrir.
+     */
+    void serve(const hittable& scene, camera& cam, const Integrator& integrator, int port) {
+        auto streamer = std::make_unique<FrameStreamer>(port, settings.image_width, image_height);
+        if (streamer->failed()) return;
+        std::printf("Aguardando visualizador na porta %d\n", port);
+        display = std::move(streamer);
+        interactive(scene, cam, integrator);
+    }
+
+private:
+    /**
+     * @brief Laço do render interativo: passadas até o `display` pedir para fechar
+     */
+    void interactive(const hittable& scene, camera& cam, const Integrator& integrator) {
+        resume(cam);
+
+        while (!display->should_close()) {
+            auto frame_start = std::chrono::steady_clock::now();
+
+            // Passada sobre todos os tiles; interrompida se a câmera se mover
+            uint64_t samples = 0;
+            FrameQuality quality = budget ? budget->quality()
+                                          : FrameQuality{settings.samples_per_pass, settings.max_depth, 1};
+            if (!run_pass(scene, cam, integrator, quality, samples)) continue;
+
+            // Um quadro vazio não mede o custo do nível; com a resolução reduzida
+            // já completa, a imagem só avança num nível mais fino
+            if (budget && samples == 0 && quality.resolution_divisor > 1)
+                budget->exhausted();
+            else if (budget)
+                record_frame(frame_start);
+
+            auto now = std::chrono::steady_clock::now();
+            if (std::chrono::duration<double>(now - last_checkpoint).count() >= settings.checkpoint_interval)
+                save_checkpoint(cam);
+
+            // Todos os pixels já têm samples_per_pixel amostras
+            if (samples == 0 && quality.resolution_divisor == 1) {
+                save_checkpoint(cam);
+
+                // Espera ociosa se terminou a imagem
+                while (!poll_camera(cam) && !display->should_close()) {
+                    SDL_Delay(50);
+                }
+            }
+        }
+
+        // Janela fechada: o destrutor do CheckpointWriter termina a gravação
+        save_checkpoint(cam);
+
+        if (budget && budget->frame_count() > 0) {
+            std::printf("Tempo de quadro (%zu quadros, alvo %.1f ms): p50 %.1f ms, p99 %.1f ms\n",
+                        budget->frame_count(), budget->target(), budget->percentile(50), budget->percentile(99));
+        }
+    }
+
+public:
+    /**
+     * @brief Inicia um render assíncrono, sem janela nem loop de eventos
+     *
+     * O job roda numa thread própria (mais as threads de render), em passadas
+     * de `samples_per_pass`, até cada pixel ter `samples_per_pixel` amostras
+     * ou até ser cancelado. Um `submit` novo cancela os jobs anteriores deste
+     * Renderer, que ficaram obsoletos (ex.: a câmera se moveu).
+     *
+     * `scene` e `integrator` precisam continuar vivos até o job terminar; a
+     * câmera e as configurações são copiadas.
+     */
+    RenderJob submit(const hittable& scene, const camera& cam, const Integrator& integrator,
+                     const RenderSettings& job_settings) {
+        for (RunningJob& job : jobs) job.state->cancel = true;
+        reap_jobs();
+
+        RenderJob handle;
+        handle.state = std::make_shared<RenderJob::State>();
+        int height = static_cast<int>(job_settings.image_width / job_settings.aspect_ratio);
+        handle.state->samples_total = uint64_t(job_settings.image_width) * height * job_settings.samples_per_pixel;
+
+        std::promise<RenderResult> promise;
+        handle.result_future = promise.get_future().share();
+
+        std::shared_ptr<RenderJob::State> state = handle.state;
+        std::thread thread([state, &scene, cam, &integrator, job_settings, promise = std::move(promise)]() mutable {
+            try {
+                promise.set_value(run_job(*state, scene, cam, integrator, job_settings));
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        });
+
+        jobs.push_back({handle.state, handle.result_future, std::move(thread)});
+        return handle;
+    }
+
+private:
+    /**
+     * @brief Corpo de um job de `submit`: passadas sobre a imagem até completar ou ser cancelado
+     */
+    static RenderResult run_job(RenderJob::State& state, const hittable& scene, const camera& cam,
+                                const Integrator& integrator, const RenderSettings& job_settings) {
+        const int height = static_cast<int>(job_settings.image_width / job_settings.aspect_ratio);
+        RenderResult result{AccumulationBuffer(job_settings.image_width, height,
+                                               job_settings.tile_size, job_settings.tile_order)};
+        const FrameQuality quality{job_settings.samples_per_pass, job_settings.max_depth, 1};
+        const int thread_count = job_settings.threads > 0 ? job_settings.threads
+                                                          : std::max(1u, std::thread::hardware_concurrency());
+
+        while (!state.cancel && result.samples < state.samples_total) {
+            std::atomic<size_t> next_tile{0};
+            std::atomic<uint64_t> pass_samples{0};
+
+            // O cancelamento é conferido antes de cada tile
+            auto worker = [&]() {
+                size_t t;
+                while (!state.cancel && (t = next_tile++) < result.image.tiles.size()) {
+                    uint64_t n = render_tile(result.image, job_settings, result.image.tiles[t],
+                                             scene, cam, integrator, quality, false);
+                    pass_samples += n;
+                    state.samples_done += n;
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (int k = 1; k < thread_count; ++k) workers.emplace_back(worker);
+            worker();
+            for (auto& w : workers) w.join();
+
+            result.samples += pass_samples;
+            if (pass_samples == 0) break;
+        }
+
+        result.cancelled = result.samples < state.samples_total;
+        return result;
+    }
+
+    /// Recolhe as threads dos jobs que já terminaram
+    void reap_jobs() {
+        for (size_t k = 0; k < jobs.size();) {
+            if (jobs[k].result.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                jobs[k].thread.join();
+                jobs.erase(jobs.begin() + k);
+            } else {
+                ++k;
+            }
+        }
+    }
+
+    /**
+     * @brief Renderiza uma passada sobre todos os tiles com as threads de render
+     *
+     * A thread principal continua tratando o input e apresentando os tiles
+     * prontos enquanto as threads de render trabalham. Com orçamento de tempo
+     * a passada é um quadro curto: o input só é lido antes dela, e a thread
+     * principal renderiza junto com as outras.
+     *
+     * @param samples Recebe o número de amostras feitas na passada
+     * @return `false` se a passada foi interrompida (câmera moveu ou janela fechou)
+     */
+    bool run_pass(const hittable& scene, camera& cam, const Integrator& integrator,
+                  const FrameQuality& quality, uint64_t& samples) {
+        if (budget) poll_camera(cam);
+
+        // As threads usam uma cópia: `cam` pode mudar durante a passada
+        const camera pass_cam = cam;
+        present_divisor = quality.resolution_divisor;
+        const bool validate = validate_history;
+
+        std::atomic<size_t> next_tile{0};
+        std::atomic<size_t> tiles_done{0};
+        std::atomic<uint64_t> pass_samples{0};
+        std::atomic<bool> cancel{false};
+        finished_tiles.clear();
+
+        auto worker = [&]() {
+            size_t t;
+            while (!cancel && (t = next_tile++) < accumulation.tiles.size()) {
+                pass_samples += render_tile(accumulation, settings, accumulation.tiles[t],
+                                            scene, pass_cam, integrator, quality, validate);
+                {
+                    std::lock_guard<std::mutex> lock(finished_mutex);
+                    finished_tiles.push_back(t);
+                }
+                tiles_done++;
+            }
+        };
+
+        int thread_count = settings.threads > 0 ? settings.threads
+                                                : std::max(1u, std::thread::hardware_concurrency());
+        if (budget) thread_count--;
+        std::vector<std::thread> workers;
+        for (int k = 0; k < thread_count; ++k) workers.emplace_back(worker);
+
+        auto stop_workers = [&]() {
+            cancel = true;
+            for (auto& w : workers) w.join();
+        };
+
+        if (budget) {
+            worker();
+        } else {
+            while (tiles_done < accumulation.tiles.size()) {
                 // Processa input e verifica se precisa reiniciar
-                bool camera_moved = window.process_input(cam);
-                if (window.should_close()) return;
+                if (poll_camera(cam, stop_workers)) return false;
+                if (display->should_close()) {
+                    stop_workers();
+                    return false;
+                }
+
+                present_finished();
+                SDL_Delay(10);
+            }
+        }
+
+        for (auto& w : workers) w.join();
+        present_finished();
+
+        // Pixels pulados em resolução reduzida ainda não conferiram o histórico
+        if (quality.resolution_divisor == 1) validate_history = false;
+        samples = pass_samples;
+        return true;
+    }
 
-                if (camera_moved) {
-                    j = image_height - 1; // Reinicia o render
-                    continue; 
+    /**
+     * @brief Processa o input e, se a câmera se moveu, reprojeta o acúmulo
+     *
+     * @param stop_workers Chamado antes de mexer no acúmulo, para parar as threads de render
+     * @return `true` se a câmera se moveu
+     */
+    template <typename StopFn>
+    bool poll_camera(camera& cam, StopFn stop_workers) {
+        camera previous = cam;
+        if (!display->process_input(cam)) return false;
+
+        stop_workers();
+
+        if (settings.temporal_reprojection) {
+            std::swap(accumulation, history);
+            reproject(history, previous, cam, accumulation, settings.samples_per_pixel);
+            validate_history = true;
+        } else {
+            accumulation.clear();
+        }
+
+        if (!budget) present(); // Com orçamento, a passada vem logo em seguida
+        return true;
+    }
+
+    bool poll_camera(camera& cam) {
+        return poll_camera(cam, []() {});
+    }
+
+    /**
+     * @brief Registra a duração do quadro no controle de orçamento e mostra os percentis no título
+     */
+    void record_frame(std::chrono::steady_clock::time_point frame_start) {
+        auto now = std::chrono::steady_clock::now();
+        budget->record(std::chrono::duration<double, std::milli>(now - frame_start).count());
+
+        if (std::chrono::duration<double>(now - last_stats).count() < 1.0) return;
+        last_stats = now;
+
+        const FrameQuality& q = budget->quality();
+        char title[160];
+        std::snprintf(title, sizeof(title), "Ray Tracer | p50 %.1f ms  p99 %.1f ms | %d spp, 1/%d",
+                      budget->percentile(50), budget->percentile(99),
+                      q.samples_per_pass, q.resolution_divisor);
+        display->set_title(title);
+    }
+
+    /**
+     * @brief Avança as amostras dos pixels de um tile
+     *
+     * Cada pixel recebe até `quality.samples_per_pass` amostras, sem passar de
+     * `samples_per_pixel`. Com resolução reduzida, só o primeiro pixel de cada
+     * bloco é amostrado. Com `validate`, o histórico reprojetado é conferido
+     * com a profundidade do primeiro hit na vista atual. Com
+     * `settings.reorder_rays` ou `settings.primary_packets`, as amostras do
+     * tile são traçadas num lote só.
+     *
+     * @return Número de amostras feitas
+     */
+    static uint64_t render_tile(AccumulationBuffer& accumulation, const RenderSettings& settings,
+                                const Tile& tile, const hittable& scene, const camera& cam,
+                                const Integrator& integrator, const FrameQuality& quality, bool validate) {
+        uint64_t samples = 0;
+        const int step = quality.resolution_divisor;
+        const bool batched = settings.reorder_rays || settings.primary_packets;
+        // A pegada é sempre a de um pixel da imagem cheia, mesmo com resolução
+        // reduzida: as amostras ficam no acúmulo, e texturas filtradas num mip
+        // mais grosso deixariam a imagem final borrada para sempre
+        const double spread = cam.pixel_spread(accumulation.width);
+
+        // Lote do tile, reaproveitado entre tiles da mesma thread
+        static thread_local RayBatch batch;
+        static thread_local std::vector<int> batch_pixels;
+        batch.clear();
+        batch_pixels.clear();
+
+        for (int j = tile.y0; j < tile.y1; j += step) {
+            for (int i = tile.x0; i < tile.x1; i += step) {
+                int idx = accumulation.index(i, j);
+
+                // Profundidade do primeiro hit no centro do pixel
+                if (validate || accumulation.count[idx] == 0) {
+                    double depth = primary_depth(accumulation, i, j, scene, cam);
+                    if (accumulation.count[idx] > 0 &&
+                        !history_valid(accumulation.depth[idx], depth, settings.reprojection_depth_tolerance)) {
+                        accumulation.reset(idx); // Desoclusão: recomeça do zero
+                    }
+                    accumulation.depth[idx] = static_cast<float>(depth);
                 }
 
-                // Renderiza a linha
-                for (int i = 0; i < settings.image_width; ++i) {
-                    color pixel_color(0, 0, 0);
-                    for (int s = 0; s < settings.samples_per_pixel; ++s) {
-                        auto u = (double(i) + random_double()) / (settings.image_width - 1);
-                        auto v = (double(j) + random_double()) / (image_height - 1);
-                        ray r = cam.get_ray(u, v);
-                        pixel_color += integrator.Li(r, scene, settings.max_depth);
+                // Só amostra o que falta para chegar em samples_per_pixel
+                int first = accumulation.count[idx];
+                int last = std::min(first + quality.samples_per_pass, settings.samples_per_pixel);
+                for (int s = first; s < last; ++s) {
+                    seed_random(sample_seed(settings.seed, idx, s));
+                    auto u = (double(i) + random_double()) / (accumulation.width - 1);
+                    auto v = (double(j) + random_double()) / (accumulation.height - 1);
+                    ray r = cam.get_ray(u, v, spread);
+                    if (batched) {
+                        batch.add(r, random_state());
+                        batch_pixels.push_back(idx);
+                    } else {
+                        accumulation.add_sample(idx, integrator.Li(r, scene, quality.max_depth));
                     }
-                    window.set_pixel(i, j, pixel_color, settings.samples_per_pixel);
                 }
-                window.refresh();
-            }
-            
-            // Espera ociosa se terminou a imagem
-            while (!window.process_input(cam) && !window.should_close()) {
-                SDL_Delay(50);
+                samples += std::max(0, last - first);
             }
         }
+
+        if (batched && batch.size() > 0) {
+            batch.packets = settings.primary_packets;
+            integrator.Li_batch(batch, scene, quality.max_depth, settings.reorder_rays);
+            for (size_t k = 0; k < batch.size(); ++k)
+                accumulation.add_sample(batch_pixels[k], batch.radiance[k]);
+        }
+
+        return samples;
+    }
+
+    /**
+     * @brief Distância da câmera ao primeiro hit do raio central do pixel
+     * @return `infinity` se o raio escapar para o céu
+     */
+    static double primary_depth(const AccumulationBuffer& accumulation, int i, int j,
+                                const hittable& scene, const camera& cam) {
+        auto u = (i + 0.5) / (accumulation.width - 1);
+        auto v = (j + 0.5) / (accumulation.height - 1);
+        ray r = cam.get_ray(u, v);
+
+        hit_record rec;
+        if (!scene.hit(r, 0.001, infinity, rec)) return infinity;
+        return rec.t * r.direction().length();
+    }
+
+    /**
+     * @brief Retoma o checkpoint, se existir um compatível com as configurações atuais
+     */
+    void resume(camera& cam) {
+        last_checkpoint = std::chrono::steady_clock::now();
+        if (!checkpoint) return;
+
+        CheckpointInfo info;
+        if (!load_checkpoint(settings.checkpoint_path, accumulation, info)) return;
+
+        if (info.samples_per_pixel != settings.samples_per_pixel || info.max_depth != settings.max_depth) {
+            std::cerr << "Checkpoint ignorado: configurações diferentes" << std::endl;
+            accumulation.clear();
+            return;
+        }
+
+        std::cout << "Retomando checkpoint " << settings.checkpoint_path << std::endl;
+        settings.seed = info.seed;
+        cam.set_position(info.camera_position);
+        present();
+    }
+
+    /**
+     * @brief Agenda um checkpoint; a gravação ocorre na thread de I/O
+     *
+     * Só é chamado entre passadas, com as threads de render paradas.
+     */
+    void save_checkpoint(const camera& cam) {
+        last_checkpoint = std::chrono::steady_clock::now();
+        if (!checkpoint) return;
+
+        CheckpointInfo info;
+        info.samples_per_pixel = settings.samples_per_pixel;
+        info.max_depth = settings.max_depth;
+        info.seed = settings.seed;
+        info.camera_position = cam.position();
+        checkpoint->submit(accumulation, info);
+    }
+
+    /**
+     * @brief Apresenta os tiles terminados desde a última chamada
+     */
+    void present_finished() {
+        std::vector<size_t> ready;
+        {
+            std::lock_guard<std::mutex> lock(finished_mutex);
+            ready.swap(finished_tiles);
+        }
+        if (ready.empty()) return;
+
+        resolve_tiles(accumulation, ready.data(), ready.size(), settings.tonemap, present_divisor,
+                      display->pixel_buffer(), settings.threads);
+        display->refresh();
+    }
+
+    /**
+     * @brief Envia todo o acúmulo para a janela (pixels sem amostras ficam pretos)
+     */
+    void present() {
+        resolve(accumulation, settings.tonemap, present_divisor, display->pixel_buffer(), settings.threads);
+        display->refresh();
     }
 
 private:
     RenderSettings settings; // Agora o compilador sabe o que é isso
     int image_height;
-    Window window;
-};
\ No newline at end of file
+    std::unique_ptr<Display> display; // Criado por render() ou serve(); jobs de submit não usam
+    AccumulationBuffer accumulation; // Amostras da vista atual
+    AccumulationBuffer history;      // Área de trabalho da reprojeção
+    bool validate_history = false;   // Acúmulo veio de reprojeção e ainda não foi conferido
+
+    // Tiles terminados pelas threads e ainda não apresentados
+    std::mutex finished_mutex;
+    std::vector<size_t> finished_tiles;
+
+    std::unique_ptr<CheckpointWriter> checkpoint;
+    std::chrono::steady_clock::time_point last_checkpoint;
+
+    std::unique_ptr<FrameBudget> budget;            // Só com target_frame_ms > 0
+    int present_divisor = 1;                        // Resolução interna da última passada
+    std::chrono::steady_clock::time_point last_stats;
+
+    // Jobs de submit ainda não recolhidos
+    struct RunningJob {
+        std::shared_ptr<RenderJob::State> state;
+        std::shared_future<RenderResult> result;
+        std::thread thread;
+    };
+    std::vector<RunningJob> jobs;
+};
@@ -0,0 +1,57 @@
+#include "reprojection.h"
+#include <algorithm>
+#include <cmath>
+
+void reproject(const AccumulationBuffer& prev, const camera& prev_cam, const camera& cam,
+               AccumulationBuffer& out, int max_history) {
+    out.clear();
+
+    const int width = prev.width;
+    const int height = prev.height;
+
+    for (int j = 0; j < height; ++j) {
+        for (int i = 0; i < width; ++i) {
+            int src = prev.index(i, j);
+            if (prev.count[src] == 0) continue;
+
+            // Raio central do pixel na vista anterior (mesma convenção de u, v do Renderer)
+            auto u = (i + 0.5) / (width - 1);
+            auto v = (j + 0.5) / (height - 1);
+            vec3 dir = unit_vector(prev_cam.get_ray(u, v).direction());
+
+            // O céu está no infinito: só a direção importa
+            bool sky = std::isinf(prev.depth[src]);
+            point3 p = sky ? cam.position() + dir
+                           : prev_cam.position() + prev.depth[src] * dir;
+
+            double nu, nv;
+            if (!cam.project(p, nu, nv)) continue;
+
+            int ni = static_cast<int>(nu * (width - 1));
+            int nj = static_cast<int>(nv * (height - 1));
+            if (ni < 0 || ni >= width || nj < 0 || nj >= height) continue;
+
+            // Teste de profundidade: o ponto mais próximo encobre os demais
+            int dst = out.index(ni, nj);
+            float depth = sky ? prev.depth[src] : static_cast<float>((p - cam.position()).length());
+            if (out.count[dst] > 0 && depth >= out.depth[dst]) continue;
+
+            // Limita o peso do histórico para que ele não domine indefinidamente
+            uint32_t kept = std::min<uint32_t>(prev.count[src], max_history);
+            float scale = static_cast<float>(kept) / prev.count[src];
+
+            out.r[dst] = prev.r[src] * scale;
+            out.g[dst] = prev.g[src] * scale;
+            out.b[dst] = prev.b[src] * scale;
+            out.count[dst] = kept;
+            out.depth[dst] = depth;
+        }
+    }
+}
+
+bool history_valid(double history_depth, double depth, double tolerance) {
+    if (std::isinf(history_depth) || std::isinf(depth))
+        return std::isinf(history_depth) && std::isinf(depth);
+
+    return std::fabs(history_depth - depth) <= tolerance * depth;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "accumulation.h"
+#include "camera.h"
+
+/**
+ * @brief Reprojeta o acúmulo de um quadro anterior para a vista atual da câmera
+ *
+ * Cada pixel com histórico em `prev` é levado ao ponto do mundo do seu primeiro
+ * hit (usando `depth`) e projetado em `cam`. Quando vários pixels caem no mesmo
+ * destino, vence o mais próximo da câmera. Pixels que não recebem nada
+ * (regiões desocluídas ou que entraram na tela) ficam com `count = 0`.
+ *
+ * @param prev Acúmulo renderizado com `prev_cam`
+ * @param prev_cam Câmera usada para renderizar `prev`
+ * @param cam Câmera atual
+ * @param out Buffer de destino (mesmas dimensões de `prev`)
+ * @param max_history Limite de amostras mantidas por pixel reprojetado
+ */
+void reproject(const AccumulationBuffer& prev, const camera& prev_cam, const camera& cam,
+               AccumulationBuffer& out, int max_history);
+
+/**
+ * @brief Verifica se a profundidade reprojetada ainda corresponde à superfície vista
+ *
+ * @param history_depth Profundidade trazida pela reprojeção
+ * @param depth Profundidade do primeiro hit medida na vista atual
+ * @param tolerance Diferença relativa máxima aceita
+ * @return true se o histórico do pixel pode ser reaproveitado
+ */
+bool history_valid(double history_depth, double depth, double tolerance);
@@ -0,0 +1,244 @@
+#include "resolve.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Abaixo disto a curva sRGB é linear
+const float srgb_threshold = 0.0031308f;
+
+// Menos tiles que isto são convertidos numa thread só
+const size_t parallel_tiles = 256;
+// Tiles pegos por vez por cada thread
+const size_t tile_batch = 16;
+
+const uint32_t opaque = 0xff000000u;
+
+// Coeficientes de log2(m) = (2 / ln 2) * (t + t^3/3 + t^5/5 + t^7/7), t = (m - 1) / (m + 1)
+const float log2_c1 = 2.8853900817779268f;
+const float log2_c3 = 0.9617966939259756f;
+const float log2_c5 = 0.5770780163555854f;
+const float log2_c7 = 0.4121985831111324f;
+const float ln2 = 0.6931471805599453f;
+
+// --- Versão escalar (também usada nas sobras de cada linha) ---
+
+inline float bits_to_float(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+inline uint32_t float_to_bits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+/// log2 para x >= 0: expoente do float + série no mantissa
+inline float fast_log2(float x) {
+    uint32_t bits = float_to_bits(x);
+    float e = static_cast<float>(static_cast<int>(bits >> 23) - 127);
+    float m = bits_to_float((bits & 0x7fffffu) | 0x3f800000u);
+    float t = (m - 1) / (m + 1);
+    float t2 = t * t;
+    return e + t * (log2_c1 + t2 * (log2_c3 + t2 * (log2_c5 + t2 * log2_c7)));
+}
+
+/// 2^y: parte inteira no expoente do float, parte fracionária por Taylor de grau 7
+inline float fast_exp2(float y) {
+    float i = std::floor(y + 0.5f);
+    float z = (y - i) * ln2;
+    float p = 1.0f / 5040;
+    p = p * z + 1.0f / 720;
+    p = p * z + 1.0f / 120;
+    p = p * z + 1.0f / 24;
+    p = p * z + 1.0f / 6;
+    p = p * z + 0.5f;
+    p = p * z + 1.0f;
+    p = p * z + 1.0f;
+    return p * bits_to_float(static_cast<uint32_t>(static_cast<int>(i) + 127) << 23);
+}
+
+inline float clamp01(float v) { return std::min(std::max(v, 0.0f), 1.0f); }
+
+inline float srgb_encode(float v) {
+    if (v <= srgb_threshold) return 12.92f * v;
+    return 1.055f * fast_exp2(fast_log2(v) * (1 / 2.4f)) - 0.055f;
+}
+
+inline float aces(float v) {
+    v = std::max(v, 0.0f);
+    return clamp01(v * (2.51f * v + 0.03f) / (v * (2.43f * v + 0.59f) + 0.14f));
+}
+
+inline float tonemap(float v, Tonemap op) {
+    switch (op) {
+        case Tonemap::SRGB: return srgb_encode(clamp01(v));
+        case Tonemap::ACES: return srgb_encode(aces(v));
+        case Tonemap::Gamma2:
+        default: return std::sqrt(clamp01(v));
+    }
+}
+
+inline uint32_t quantize(float v) { return static_cast<uint32_t>(256 * std::min(v, 0.999f)); }
+
+uint32_t resolve_pixel(const AccumulationBuffer& acc, int idx, Tonemap op) {
+    if (acc.count[idx] == 0) return opaque;
+    float scale = 1.0f / acc.count[idx];
+    return opaque | quantize(tonemap(acc.r[idx] * scale, op)) << 16
+                  | quantize(tonemap(acc.g[idx] * scale, op)) << 8
+                  | quantize(tonemap(acc.b[idx] * scale, op));
+}
+
+/// Pixel sem amostras em resolução reduzida: usa o pixel amostrado do bloco
+uint32_t fill_pixel(const AccumulationBuffer& acc, int i, int j, int divisor, Tonemap op) {
+    return resolve_pixel(acc, acc.index(i - i % divisor, j - j % divisor), op);
+}
+
+// --- Versão AVX2: 8 pixels de uma linha do tile por vez ---
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+inline __m256 log2_8(__m256 x) {
+    __m256i bits = _mm256_castps_si256(x);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x7fffff)),
+                                                   _mm256_set1_epi32(0x3f800000)));
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 t = _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+    __m256 t2 = _mm256_mul_ps(t, t);
+    __m256 p = _mm256_fmadd_ps(t2, _mm256_set1_ps(log2_c7), _mm256_set1_ps(log2_c5));
+    p = _mm256_fmadd_ps(t2, p, _mm256_set1_ps(log2_c3));
+    p = _mm256_fmadd_ps(t2, p, _mm256_set1_ps(log2_c1));
+    return _mm256_fmadd_ps(t, p, e);
+}
+
+inline __m256 exp2_8(__m256 y) {
+    __m256 i = _mm256_floor_ps(_mm256_add_ps(y, _mm256_set1_ps(0.5f)));
+    __m256 z = _mm256_mul_ps(_mm256_sub_ps(y, i), _mm256_set1_ps(ln2));
+    __m256 p = _mm256_set1_ps(1.0f / 5040);
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.0f / 720));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.0f / 120));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.0f / 24));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.0f / 6));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(0.5f));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.0f));
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(1.0f));
+    __m256i power = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(i), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(power));
+}
+
+inline __m256 clamp01_8(__m256 v) {
+    return _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+}
+
+inline __m256 srgb_encode_8(__m256 v) {
+    __m256 linear = _mm256_mul_ps(v, _mm256_set1_ps(12.92f));
+    __m256 curve = exp2_8(_mm256_mul_ps(log2_8(v), _mm256_set1_ps(1 / 2.4f)));
+    curve = _mm256_fmsub_ps(curve, _mm256_set1_ps(1.055f), _mm256_set1_ps(0.055f));
+    return _mm256_blendv_ps(curve, linear, _mm256_cmp_ps(v, _mm256_set1_ps(srgb_threshold), _CMP_LE_OQ));
+}
+
+inline __m256 aces_8(__m256 v) {
+    v = _mm256_max_ps(v, _mm256_setzero_ps());
+    __m256 num = _mm256_mul_ps(v, _mm256_fmadd_ps(v, _mm256_set1_ps(2.51f), _mm256_set1_ps(0.03f)));
+    __m256 den = _mm256_fmadd_ps(v, _mm256_fmadd_ps(v, _mm256_set1_ps(2.43f), _mm256_set1_ps(0.59f)),
+                                 _mm256_set1_ps(0.14f));
+    return clamp01_8(_mm256_div_ps(num, den));
+}
+
+inline __m256 tonemap_8(__m256 v, Tonemap op) {
+    switch (op) {
+        case Tonemap::SRGB: return srgb_encode_8(clamp01_8(v));
+        case Tonemap::ACES: return srgb_encode_8(aces_8(v));
+        case Tonemap::Gamma2:
+        default: return _mm256_sqrt_ps(clamp01_8(v));
+    }
+}
+
+inline __m256i quantize_8(__m256 v) {
+    return _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_min_ps(v, _mm256_set1_ps(0.999f)), _mm256_set1_ps(256.0f)));
+}
+
+#endif
+
+void resolve_tile(const AccumulationBuffer& acc, size_t t, Tonemap op, int fill_divisor, uint32_t* pixels) {
+    const Tile& tile = acc.tiles[t];
+    const int tile_size = acc.tile_size;
+
+    for (int j = tile.y0; j < tile.y1; ++j) {
+        uint32_t* row = pixels + static_cast<size_t>(acc.height - 1 - j) * acc.width;
+        int idx = static_cast<int>(t * tile_size * tile_size) + (j - tile.y0) * tile_size;
+        int i = tile.x0;
+
+#if defined(__AVX2__) && defined(__FMA__)
+        for (; i + 8 <= tile.x1; i += 8, idx += 8) {
+            __m256 count = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&acc.count[idx])));
+            __m256 empty = _mm256_cmp_ps(count, _mm256_setzero_ps(), _CMP_EQ_OQ);
+            __m256 scale = _mm256_andnot_ps(empty, _mm256_div_ps(_mm256_set1_ps(1.0f), count));
+
+            __m256i r = quantize_8(tonemap_8(_mm256_mul_ps(_mm256_loadu_ps(&acc.r[idx]), scale), op));
+            __m256i g = quantize_8(tonemap_8(_mm256_mul_ps(_mm256_loadu_ps(&acc.g[idx]), scale), op));
+            __m256i b = quantize_8(tonemap_8(_mm256_mul_ps(_mm256_loadu_ps(&acc.b[idx]), scale), op));
+
+            __m256i packed = _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi32(static_cast<int>(opaque)),
+                                                             _mm256_slli_epi32(r, 16)),
+                                             _mm256_or_si256(_mm256_slli_epi32(g, 8), b));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), packed);
+
+            if (fill_divisor > 1) {
+                for (int mask = _mm256_movemask_ps(empty); mask; mask &= mask - 1) {
+                    int k = __builtin_ctz(mask);
+                    row[i + k] = fill_pixel(acc, i + k, j, fill_divisor, op);
+                }
+            }
+        }
+#endif
+
+        for (; i < tile.x1; ++i, ++idx) {
+            if (acc.count[idx] == 0 && fill_divisor > 1)
+                row[i] = fill_pixel(acc, i, j, fill_divisor, op);
+            else
+                row[i] = resolve_pixel(acc, idx, op);
+        }
+    }
+}
+
+} // namespace
+
+void resolve_tiles(const AccumulationBuffer& accumulation, const size_t* tiles, size_t tile_count,
+                   Tonemap op, int fill_divisor, uint32_t* pixels, int threads) {
+    int thread_count = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    if (tile_count < parallel_tiles) thread_count = 1;
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        size_t first;
+        while ((first = next.fetch_add(tile_batch)) < tile_count) {
+            size_t last = std::min(first + tile_batch, tile_count);
+            for (size_t k = first; k < last; ++k)
+                resolve_tile(accumulation, tiles[k], op, fill_divisor, pixels);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int k = 1; k < thread_count; ++k) workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers) w.join();
+}
+
+void resolve(const AccumulationBuffer& accumulation, Tonemap op, int fill_divisor, uint32_t* pixels, int threads) {
+    std::vector<size_t> all(accumulation.tiles.size());
+    std::iota(all.begin(), all.end(), 0);
+    resolve_tiles(accumulation, all.data(), all.size(), op, fill_divisor, pixels, threads);
+}
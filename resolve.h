@@ -0,0 +1,39 @@
+#pragma once
+
+#include "accumulation.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Operador de tonemap aplicado na conversão para 8 bits
+ */
+enum class Tonemap {
+    Gamma2, // sqrt(x): a correção gama original do projeto
+    SRGB,   // Curva sRGB
+    ACES    // Curva filmica ACES (aproximação de Narkowicz) seguida da curva sRGB
+};
+
+/**
+ * @brief Converte tiles do acúmulo para pixels ARGB8888
+ *
+ * Para cada pixel: média das amostras, tonemap, clamp e quantização para 8
+ * bits, empacotando em `0xAARRGGBB`. Com AVX2, 8 pixels de uma linha do tile
+ * são convertidos por vez; sem AVX2, um a um. O sRGB usa log2/exp2 por
+ * polinômios (erro de no máximo 1 nível em 8 bits).
+ *
+ * @param accumulation Acúmulo de origem
+ * @param tiles Índices em `accumulation.tiles` a converter
+ * @param tile_count Quantidade de índices
+ * @param op Operador de tonemap
+ * @param fill_divisor Com valor > 1, pixels sem amostras mostram o pixel
+ *        (i - i % d, j - j % d) do seu bloco (render em resolução reduzida)
+ * @param pixels Framebuffer `width x height`, linha 0 no topo (y invertido)
+ * @param threads Threads usadas (0 = uma por núcleo); poucos tiles usam uma só
+ */
+void resolve_tiles(const AccumulationBuffer& accumulation, const size_t* tiles, size_t tile_count,
+                   Tonemap op, int fill_divisor, uint32_t* pixels, int threads);
+
+/**
+ * @brief Converte o acúmulo inteiro (ver `resolve_tiles`)
+ */
+void resolve(const AccumulationBuffer& accumulation, Tonemap op, int fill_divisor, uint32_t* pixels, int threads);
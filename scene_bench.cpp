@@ -0,0 +1,101 @@
+// Mede a montagem de cenas grandes: tempo e memória por esfera da montagem
+// antiga (um `make_shared` por esfera em `hittable_list` + `bvh`) contra a do
+// `scene_builder` (arenas + `freeze()` numa `flat_scene`), e a vazão de raios
+// da câmera em cada uma.
+//
+//   rtscenebench [esferas] [--rays <n>]
+//
+// Cada montagem roda num processo filho, para a memória de uma não contar na
+// outra; a memória é a diferença do RSS antes e depois de montar a cena.
+
+#include "bvh.h"
+#include "camera.h"
+#include "hittable_list.h"
+#include "scenes.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double seconds_since(clock_type::time_point start) {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+/// Memória residente do processo, em bytes
+size_t resident_bytes() {
+    long pages = 0, resident = 0;
+    if (std::FILE* f = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+        std::fclose(f);
+    }
+    return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+void measure(size_t count, bool flat, int rays) {
+    const size_t rss_before = resident_bytes();
+    auto start = clock_type::now();
+
+    hittable_list world;
+    sphere_field_scene(world, count, flat);
+    const double objects_seconds = seconds_since(start);
+    bvh scene(world.objects);
+    const double total_seconds = seconds_since(start);
+    const size_t bytes = resident_bytes() - rss_before;
+
+    // Raios da câmera numa grade fixa: as duas montagens veem os mesmos raios
+    camera cam;
+    const int side = 512;
+    size_t hits = 0;
+    double t_sum = 0;
+    start = clock_type::now();
+    for (int k = 0; k < rays; ++k) {
+        int p = k % (side * side);
+        hit_record rec;
+        if (scene.hit(cam.get_ray((p % side + 0.5) / side, (p / side + 0.5) / side), 0.001, infinity, rec)) {
+            hits++;
+            t_sum += rec.t;
+        }
+    }
+    const double ray_seconds = seconds_since(start);
+
+    std::printf("%-26s %6.2f s (objetos %6.2f s)  %6.1f bytes/esfera  %6.2f Mraios/s  [%zu hits, t médio %.6f]\n",
+                flat ? "scene_builder + freeze()" : "make_shared + bvh", total_seconds, objects_seconds,
+                double(bytes) / count, rays / ray_seconds / 1e6, hits, hits ? t_sum / hits : 0.0);
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = 10000000;
+    int rays = 1 << 20;
+    for (int k = 1; k < argc; ++k) {
+        std::string arg = argv[k];
+        if (arg == "--rays" && k + 1 < argc)
+            rays = std::stoi(argv[++k]);
+        else
+            count = std::stoull(arg);
+    }
+
+    std::printf("%zu esferas, %d raios\n", count, rays);
+    std::fflush(stdout);
+    for (bool flat : {false, true}) {
+        pid_t child = fork();
+        if (child == 0) {
+            measure(count, flat, rays);
+            _exit(0);
+        }
+        int status = 0;
+        if (child < 0 || waitpid(child, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::fprintf(stderr, "A medição de %s falhou\n", flat ? "scene_builder" : "make_shared");
+            return 1;
+        }
+    }
+    return 0;
+}
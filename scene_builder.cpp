@@ -0,0 +1,47 @@
+#include "scene_builder.h"
+
+scene_builder::scene_builder()
+    : material_arena(64 << 10), primitive_arena(chunk_size * sizeof(sphere_record)) {}
+
+void scene_builder::add_sphere(const point3& center, double radius, material_id mat) {
+    if (count % chunk_size == 0) {
+        void* memory = primitive_arena.allocate(chunk_size * sizeof(sphere_record), alignof(sphere_record));
+        chunks.push_back(static_cast<sphere_record*>(memory));
+    }
+
+    chunks.back()[count % chunk_size] = {center, radius, mat};
+    ++count;
+}
+
+flat_scene scene_builder::freeze() {
+    flat_scene scene;
+    scene.center_x.resize(count);
+    scene.center_y.resize(count);
+    scene.center_z.resize(count);
+    scene.radius.resize(count);
+    scene.material_index.resize(count);
+
+    for (size_t k = 0; k < count; ++k) {
+        const sphere_record& s = chunks[k / chunk_size][k % chunk_size];
+        scene.center_x[k] = s.center.x();
+        scene.center_y[k] = s.center.y();
+        scene.center_z[k] = s.center.z();
+        scene.radius[k] = s.radius;
+        scene.material_index[k] = s.mat;
+    }
+
+    // Os materiais não mudam de lugar: a arena inteira passa para a cena
+    scene.materials = std::move(materials);
+    scene.material_arena = std::move(material_arena);
+
+    scene.build_tree();
+
+    // Esvazia o builder (os registros temporários das esferas são liberados)
+    materials.clear();
+    chunks.clear();
+    count = 0;
+    primitive_arena = Arena(chunk_size * sizeof(sphere_record));
+    material_arena = Arena(64 << 10);
+
+    return scene;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "arena.h"
+#include "flat_scene.h"
+#include "vec3.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class material;
+
+/**
+ * @class scene_builder
+ * @brief Monta uma cena grande sem uma alocação de heap por objeto
+ *
+ * Materiais e esferas são criados em arenas (alocação por incremento de
+ * ponteiro, sem blocos de controle de `shared_ptr`). `freeze()` compacta as
+ * esferas em vetores contíguos e devolve uma `flat_scene` pronta para o render.
+ *
+ * Uso:
+ *   scene_builder builder;
+ *   auto ground = builder.add_material<lambertian>(color(0.5, 0.5, 0.5));
+ *   builder.add_sphere(point3(0, -1000, 0), 1000, ground);
+ *   flat_scene world = builder.freeze();
+ */
+class scene_builder {
+    public:
+        /// Identificador de um material criado por `add_material`
+        using material_id = uint32_t;
+
+        scene_builder();
+
+        /**
+         * @brief Cria um material na arena de materiais
+         * @return Identificador a ser passado para `add_sphere`
+         */
+        template <typename M, typename... Args>
+        material_id add_material(Args&&... args) {
+            materials.push_back(material_arena.create<M>(std::forward<Args>(args)...));
+            return static_cast<material_id>(materials.size() - 1);
+        }
+
+        /// Adiciona uma esfera
+        void add_sphere(const point3& center, double radius, material_id mat);
+
+        /// Número de esferas adicionadas
+        size_t sphere_count() const { return count; }
+
+        /**
+         * @brief Compacta a cena em vetores contíguos; o builder fica vazio
+         */
+        flat_scene freeze();
+
+    private:
+        struct sphere_record {
+            point3 center;
+            double radius;
+            material_id mat;
+        };
+
+        // As esferas são guardadas em blocos de tamanho fixo dentro da arena
+        static const size_t chunk_size = 4096;
+
+        Arena material_arena;
+        Arena primitive_arena;
+        std::vector<const material*> materials;
+        std::vector<sphere_record*> chunks;
+        size_t count = 0;
+};
@@ -0,0 +1,196 @@
+#include "scenes.h"
+#include "sphere.h"
+#include "material.h"
+#include "image_texture.h"
+#include "scene_builder.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+uint32_t lattice_hash(uint32_t x, uint32_t y, uint32_t seed) {
+    uint32_t h = x * 0x8da6b343u ^ y * 0xd8163841u ^ seed * 0xcb1ab31fu;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    return h ^ (h >> 15);
+}
+
+/// Ruído de valor em (x, y) com período `period` em x (para a textura fechar em u)
+double value_noise(double x, double y, int period, uint32_t seed) {
+    int x0 = static_cast<int>(std::floor(x)), y0 = static_cast<int>(std::floor(y));
+    double fx = x - x0, fy = y - y0;
+    fx = fx * fx * (3 - 2 * fx);
+    fy = fy * fy * (3 - 2 * fy);
+    auto at = [&](int i, int j) {
+        return (lattice_hash(((i % period) + period) % period, j, seed) & 0xffff) / 65535.0;
+    };
+    return (1 - fy) * ((1 - fx) * at(x0, y0) + fx * at(x0 + 1, y0))
+         + fy * ((1 - fx) * at(x0, y0 + 1) + fx * at(x0 + 1, y0 + 1));
+}
+
+/**
+ * @brief Abre a textura de `path`, gerando-a antes se ainda não existir
+ *
+ * A imagem é ruído em oitavas entre duas cores sorteadas por `seed`, com
+ * meridianos e paralelos escuros: tem detalhe em todas as escalas, o que
+ * deixa a escolha do nível de mip visível.
+ */
+std::shared_ptr<image_texture> procedural_texture(const std::string& path, int width, uint32_t seed, TileCache& cache) {
+    if (auto tex = image_texture::open(path, cache)) return tex;
+
+    const int height = width / 2;
+    auto channel = [&](int k) { return 0.15 + 0.8 * (lattice_hash(k, 7, seed) & 0xff) / 255.0; };
+    const color a(channel(0), channel(1), channel(2));
+    const color b(channel(3), channel(4), channel(5));
+
+    std::vector<uint8_t> srgb(3ull * width * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            double u = (x + 0.5) / width, v = (y + 0.5) / height;
+            double n = 0, amplitude = 0.5;
+            for (int octave = 0; octave < 5; ++octave) {
+                int period = 8 << octave;
+                n += amplitude * value_noise(u * period, v * period / 2, period, seed + octave);
+                amplitude /= 2;
+            }
+            color c = a + (n / 0.97) * (b - a);
+            if (x % (width / 16) < 2 || y % (height / 8) < 2) c *= 0.3;
+            for (int k = 0; k < 3; ++k)
+                srgb[3 * (size_t(y) * width + x) + k] = static_cast<uint8_t>(256 * clamp(c[k], 0.0, 0.999));
+        }
+    }
+    if (!image_texture::write(path, width, height, srgb)) return nullptr;
+    return image_texture::open(path, cache);
+}
+
+} // namespace
+
+void default_scene(hittable_list& world) {
+    scene_builder builder;
+    auto mat_ground = builder.add_material<lambertian>(color(0.8, 0.8, 0.0));
+    auto mat_center = builder.add_material<lambertian>(color(0.1, 0.2, 0.5));
+    auto mat_left   = builder.add_material<metal>(color(0.8, 0.8, 0.8), 0.3);
+    auto mat_right  = builder.add_material<metal>(color(0.8, 0.6, 0.2), 0.0);
+
+    builder.add_sphere(point3( 0.0, -100.5, -1.0), 100.0, mat_ground);
+    builder.add_sphere(point3( 0.0,    0.0, -1.0),   0.5, mat_center);
+    builder.add_sphere(point3(-1.0,    0.0, -1.0),   0.5, mat_left);
+    builder.add_sphere(point3( 1.0,    0.0, -1.0),   0.5, mat_right);
+    world.add(make_shared<flat_scene>(builder.freeze()));
+}
+
+void sphere_field_scene(hittable_list& world, size_t count, bool flat) {
+    const int material_count = 16;
+    const int side = static_cast<int>(std::ceil(std::sqrt(double(count))));
+    const double spacing = 0.25, radius = 0.08;
+
+    // Materiais e posições saem de um hash: as duas montagens geram a mesma cena
+    auto unit = [](uint32_t x, uint32_t y, uint32_t seed) { return (lattice_hash(x, y, seed) & 0xffff) / 65535.0; };
+    auto material_color = [&](int m) { return color(0.2 + 0.7 * unit(m, 0, 1), 0.2 + 0.7 * unit(m, 1, 1), 0.2 + 0.7 * unit(m, 2, 1)); };
+    auto position = [&](size_t k) {
+        uint32_t i = static_cast<uint32_t>(k % side), j = static_cast<uint32_t>(k / side);
+        return point3((i - 0.5 * side + unit(i, j, 2)) * spacing, radius - 0.5, -1.5 - (j + unit(i, j, 3)) * spacing);
+    };
+    auto material_of = [&](size_t k) { return static_cast<int>(lattice_hash(uint32_t(k), 0, 4) % material_count); };
+
+    const color ground(0.5, 0.5, 0.5);
+    if (flat) {
+        scene_builder builder;
+        std::vector<scene_builder::material_id> materials;
+        for (int m = 0; m < material_count; ++m)
+            materials.push_back(m % 4 == 3 ? builder.add_material<metal>(material_color(m), 0.1)
+                                           : builder.add_material<lambertian>(material_color(m)));
+        builder.add_sphere(point3(0, -1000.5, -1), 1000, builder.add_material<lambertian>(ground));
+        for (size_t k = 0; k < count; ++k)
+            builder.add_sphere(position(k), radius, materials[material_of(k)]);
+        world.add(make_shared<flat_scene>(builder.freeze()));
+        return;
+    }
+
+    std::vector<shared_ptr<material>> materials;
+    for (int m = 0; m < material_count; ++m) {
+        if (m % 4 == 3)
+            materials.push_back(make_shared<metal>(material_color(m), 0.1));
+        else
+            materials.push_back(make_shared<lambertian>(material_color(m)));
+    }
+    world.add(make_shared<sphere>(point3(0, -1000.5, -1), 1000, make_shared<lambertian>(ground)));
+    for (size_t k = 0; k < count; ++k)
+        world.add(make_shared<sphere>(position(k), radius, materials[material_of(k)]));
+}
+
+void many_lights_scene(hittable_list& world, LightSampler& lights, int light_count) {
+    default_scene(world);
+
+    // Esferas emissoras pequenas espalhadas acima e atrás das esferas principais
+    const double radius = 0.02;
+    for (int k = 0; k < light_count; ++k) {
+        point3 center(random_double(-4.0, 4.0), random_double(0.6, 3.0), random_double(-6.0, -0.5));
+        color emission = 40.0 * color(random_double(0.5, 1.0), random_double(0.5, 1.0), random_double(0.5, 1.0));
+
+        auto light = make_shared<sphere>(center, radius, make_shared<diffuse_light>(emission));
+        world.add(light);
+
+        // Peso proporcional à potência: área vezes radiância média
+        double power = 4 * pi * radius * radius * (emission.x() + emission.y() + emission.z()) / 3;
+        lights.add(light, power);
+    }
+
+    lights.build();
+}
+
+void diffuse_scene(hittable_list& world, LightSampler& lights) {
+    auto mat_ground = make_shared<lambertian>(color(0.75, 0.75, 0.75));
+    auto mat_room   = make_shared<lambertian>(color(0.8, 0.75, 0.7));
+    world.add(make_shared<sphere>(point3(0.0, -100.5, -1.0), 100.0, mat_ground));
+
+    // Sala fechada: o interior de uma esfera grande, sem saída para o céu
+    world.add(make_shared<sphere>(point3(0.0, 0.0, -1.0), 8.0, mat_room));
+
+    // Esferas claras e encostadas umas nas outras: muita luz rebate entre elas
+    const color albedos[] = {
+        color(0.8, 0.3, 0.3), color(0.3, 0.8, 0.3), color(0.3, 0.3, 0.8),
+        color(0.8, 0.8, 0.8), color(0.8, 0.7, 0.3)
+    };
+    for (int k = 0; k < 5; ++k) {
+        point3 center(-1.6 + 0.8 * k, -0.1, -1.6 - 0.4 * (k % 2));
+        world.add(make_shared<sphere>(center, 0.4, make_shared<lambertian>(albedos[k])));
+    }
+    world.add(make_shared<sphere>(point3(0.0, 0.55, -1.9), 0.35, make_shared<lambertian>(color(0.85, 0.85, 0.85))));
+
+    // Uma luz só, acima e atrás da câmera: quase tudo que se vê é luz indireta
+    const double radius = 0.5;
+    const color emission(12.0, 11.0, 10.0);
+    auto light = make_shared<sphere>(point3(0.0, 4.0, 2.0), radius, make_shared<diffuse_light>(emission));
+    world.add(light);
+    lights.add(light, 4 * pi * radius * radius * (emission.x() + emission.y() + emission.z()) / 3);
+    lights.build();
+}
+
+bool textured_scene(hittable_list& world, TileCache& cache, const std::string& directory, int texture_width) {
+    int count = 0;
+    auto textured = [&](double fuzz) -> shared_ptr<material> {
+        std::string path = directory + "/texture_" + std::to_string(count) + "_" + std::to_string(texture_width) + ".rtmip";
+        auto tex = procedural_texture(path, texture_width, count++, cache);
+        if (!tex) return nullptr;
+        if (fuzz < 0) return make_shared<lambertian>(tex);
+        return make_shared<metal>(tex, fuzz);
+    };
+
+    auto ground = textured(-1);
+    if (!ground) return false;
+    world.add(make_shared<sphere>(point3(0.0, -100.5, -1.0), 100.0, ground));
+
+    // 4 fileiras de 7 esferas em degraus, para as de trás aparecerem; uma
+    // textura por esfera, e uma em cada cinco é metálica
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 7; ++col) {
+            auto mat = textured(count % 5 == 0 ? 0.2 : -1);
+            if (!mat) return false;
+            point3 center(-3.0 + col + 0.5 * (row % 2), -0.15 + 0.4 * row, -1.8 - 1.2 * row);
+            world.add(make_shared<sphere>(center, 0.35, mat));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "hittable_list.h"
+#include "light_sampler.h"
+#include "tile_cache.h"
+#include <string>
+
+/**
+ * @brief Cena padrão: chão, uma esfera difusa e duas metálicas
+ */
+void default_scene(hittable_list& world);
+
+/**
+ * @brief Campo plano de `count` esferas pequenas sobre o chão, à frente da câmera
+ *
+ * As esferas ficam numa grade com deslocamento aleatório (sempre o mesmo para
+ * o mesmo `count`) e dividem 16 materiais difusos e metálicos. Com `flat`, a
+ * cena é montada pelo `scene_builder` e entra em `world` como uma única
+ * `flat_scene`; sem, cada esfera e material é um `make_shared` (a montagem
+ * antiga, mantida para comparação).
+ */
+void sphere_field_scene(hittable_list& world, size_t count, bool flat = true);
+
+/**
+ * @brief Sala fechada só com materiais difusos claros e uma luz
+ *
+ * Sem céu, e a luz fica fora do campo de visão: a maior parte do que se vê
+ * chega por interreflexão difusa (usada para avaliar o cache de irradiância).
+ *
+ * @param world Lista que recebe todos os objetos
+ * @param lights Recebe a esfera emissora (a tabela de alias já vem montada)
+ */
+void diffuse_scene(hittable_list& world, LightSampler& lights);
+
+/**
+ * @brief Cena iluminada apenas por muitas esferas emissoras pequenas
+ *
+ * Usada para comparar integradores: sem céu, a luz só chega à cena pelas
+ * esferas emissoras, que são registradas também em `lights`.
+ *
+ * @param world Lista que recebe todos os objetos
+ * @param lights Recebe as esferas emissoras (a tabela de alias já vem montada)
+ * @param light_count Número de esferas emissoras
+ */
+void many_lights_scene(hittable_list& world, LightSampler& lights, int light_count = 1000);
+
+/**
+ * @brief Grade de esferas, cada uma com a sua textura de imagem
+ *
+ * As texturas (procedurais, `texture_width` x `texture_width / 2`) ficam em
+ * arquivos `.rtmip` em `directory` e são geradas na primeira vez. Todas
+ * passam pelo mesmo `cache`, que decide quanto delas fica em memória.
+ *
+ * @param world Lista que recebe todos os objetos
+ * @param cache Cache de tiles das texturas; precisa viver tanto quanto a cena
+ * @param directory Pasta dos arquivos de textura (precisa existir)
+ * @return false se alguma textura não pôde ser gravada ou aberta
+ */
+bool textured_scene(hittable_list& world, TileCache& cache, const std::string& directory, int texture_width = 2048);
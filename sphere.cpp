@@ -1,4 +1,6 @@
 #include "sphere.h"
+#include "utils.h"
+#include <algorithm>
 
 // Construtor vazio
 sphere::sphere() {}
@@ -30,9 +32,80 @@ bool sphere::hit(const ray& r, double t_min, double t_max, hit_record& rec) cons
     rec.p = r.at(rec.t);
     vec3 outward_normal = (rec.p - center) / radius;
     
-    bool front_face = dot(r.direction(), outward_normal) < 0;
-    rec.normal = front_face ? outward_normal : -outward_normal;
-    rec.mat_ptr = mat_ptr;
+    rec.front_face = dot(r.direction(), outward_normal) < 0;
+    rec.normal = rec.front_face ? outward_normal : -outward_normal;
+    rec.mat_ptr = mat_ptr.get();
+    rec.object = this;
 
     return true;
-}
\ No newline at end of file
+}
+
+bool sphere::hit_any(const ray& r, double t_min, double t_max) const {
+    vec3 oc = r.origin() - center;
+    auto a = r.direction().length_squared();
+    auto half_b = dot(oc, r.direction());
+    auto c = oc.length_squared() - radius*radius;
+
+    auto discriminant = half_b*half_b - a*c;
+    if (discriminant < 0) return false;
+    auto sqrtd = sqrt(discriminant);
+
+    // Basta uma das raízes cair no intervalo
+    auto root = (-half_b - sqrtd) / a;
+    if (root >= t_min && root <= t_max) return true;
+    root = (-half_b + sqrtd) / a;
+    return root >= t_min && root <= t_max;
+}
+
+bool sphere::bounding_box(aabb& output_box) const {
+    vec3 extent(radius, radius, radius);
+    output_box = aabb(center - extent, center + extent);
+    return true;
+}
+
+// 1 - cos(theta_max) do cone que a esfera subtende a uma distância d.
+// Escrito assim para não perder precisão com esferas pequenas e distantes.
+static double one_minus_cos_theta_max(double radius, double distance_squared) {
+    auto ratio = radius*radius / distance_squared;
+    return ratio / (1 + sqrt(1 - ratio));
+}
+
+double sphere::pdf_value(const point3& origin, const vec3& direction) const {
+    hit_record rec;
+    if (!this->hit(ray(origin, direction), 0.001, infinity, rec))
+        return 0;
+
+    auto distance_squared = (center - origin).length_squared();
+    if (distance_squared <= radius*radius)
+        return 0; // Origem dentro da esfera: não amostrada por cone
+
+    auto solid_angle = 2*pi*one_minus_cos_theta_max(radius, distance_squared);
+    return 1 / solid_angle;
+}
+
+vec3 sphere::random(const point3& origin) const {
+    vec3 direction = center - origin;
+    auto distance_squared = direction.length_squared();
+    if (distance_squared <= radius*radius)
+        return random_unit_vector();
+
+    // Direção uniforme no cone de abertura theta_max, em coordenadas locais (z = eixo)
+    auto r1 = random_double();
+    auto r2 = random_double();
+    auto z = 1 - r2*one_minus_cos_theta_max(radius, distance_squared);
+    auto phi = 2*pi*r1;
+    auto sin_theta = sqrt(std::max(0.0, 1 - z*z));
+
+    // Base ortonormal com w apontando para o centro da esfera
+    vec3 w = unit_vector(direction);
+    vec3 a = (std::fabs(w.x()) > 0.9) ? vec3(0, 1, 0) : vec3(1, 0, 0);
+    vec3 v = unit_vector(cross(w, a));
+    vec3 u = cross(w, v);
+
+    return cos(phi)*sin_theta*u + sin(phi)*sin_theta*v + z*w;
+}
+
+double sphere::surface_uv(const hit_record& rec, double& u, double& v) const {
+    sphere_uv((rec.p - center) / radius, u, v);
+    return pi * radius;
+}
@@ -2,6 +2,9 @@
 
 #include "hittable.h"
 #include "vec3.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
 #include <memory>
 
 using std::shared_ptr; 
@@ -58,8 +61,52 @@ class sphere : public hittable {
          */
         virtual bool hit(const ray& r, double t_min, double t_max, hit_record& rec) const override;
 
+        /**
+         * @brief Teste de oclusão: só resolve a equação de segundo grau,
+         *        sem calcular ponto, normal ou material.
+         */
+        virtual bool hit_any(const ray& r, double t_min, double t_max) const override;
+
+        /**
+         * @brief Caixa de lado 2R centrada em `center`. Se `center` mudar,
+         *        a BVH que contém a esfera precisa ser avisada (`bvh::mark_moved`).
+         */
+        virtual bool bounding_box(aabb& output_box) const override;
+
+        /**
+         * @brief Densidade de `random` por ângulo sólido: uniforme no cone que
+         *        a esfera subtende visto de `origin`.
+         */
+        virtual double pdf_value(const point3& origin, const vec3& direction) const override;
+
+        /**
+         * @brief Sorteia uma direção uniforme dentro do cone que a esfera
+         *        subtende visto de `origin` (usado para amostrar esferas emissoras).
+         */
+        virtual vec3 random(const point3& origin) const override;
+
+        /**
+         * @brief Coordenadas esféricas do ponto (ver `sphere_uv`); uma unidade
+         *        de `v` vai de um polo ao outro (comprimento pi * R).
+         */
+        virtual double surface_uv(const hit_record& rec, double& u, double& v) const override;
+
     public:
         point3 center;
         double radius;
         shared_ptr<material> mat_ptr;
 };
+
+/**
+ * @brief Coordenadas de textura de um ponto da esfera unitária
+ *
+ * `u` é o ângulo em torno do eixo y (0 em -x, crescendo para -z, +x, +z) e
+ * `v` vai de 0 no polo y = -1 a 1 no polo y = +1: uma textura 2:1 tem
+ * texels quadrados no equador.
+ *
+ * @param n Ponto na esfera de raio 1 centrada na origem (normal externa)
+ */
+inline void sphere_uv(const vec3& n, double& u, double& v) {
+    u = (std::atan2(-n.z(), n.x()) + pi) / (2 * pi);
+    v = std::acos(std::clamp(-n.y(), -1.0, 1.0)) / pi;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "color.h"
+#include "hittable.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @class texture
+ * @brief Cor que varia sobre a superfície, nas coordenadas (u, v) do objeto
+ */
+class texture {
+    public:
+        /**
+         * @brief Cor da textura em (u, v)
+         *
+         * @param footprint Largura da área a filtrar, em unidades de `v`
+         *        (0 = só o ponto); escolhe o nível de mip
+         */
+        virtual color value(double u, double v, double footprint) const = 0;
+
+        virtual ~texture() = default;
+};
+
+class solid_color : public texture {
+    public:
+        solid_color(const color& c) : color_value(c) {}
+
+        virtual color value(double u, double v, double footprint) const override {
+            return color_value;
+        }
+
+    private:
+        color color_value;
+};
+
+/**
+ * @brief Cor de `tex` no ponto de `rec`, filtrada pela pegada de `r_in`
+ *
+ * A pegada do raio no ponto é projetada na superfície (dividida pelo cosseno
+ * com a normal, limitado para não explodir em ângulos rasantes) e convertida
+ * para unidades de `v` com o comprimento devolvido por `hittable::surface_uv`.
+ */
+inline color texture_value(const texture& tex, const ray& r_in, const hit_record& rec) {
+    double u = 0, v = 0, length = 0;
+    if (rec.object) length = rec.object->surface_uv(rec, u, v);
+
+    double footprint = 0;
+    if (length > 0) {
+        double cos_theta = std::fabs(dot(unit_vector(r_in.direction()), rec.normal));
+        footprint = r_in.footprint(rec.t) / (std::max(cos_theta, 0.1) * length);
+    }
+    return tex.value(u, v, footprint);
+}
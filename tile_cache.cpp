@@ -0,0 +1,86 @@
+#include "tile_cache.h"
+#include <algorithm>
+
+namespace {
+
+// Mistura os bits da chave (finalizador do splitmix64): tiles vizinhos caem em fatias diferentes
+inline uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+} // namespace
+
+namespace {
+
+// `shard_for` escolhe a fatia com uma máscara: o número de fatias precisa ser potência de 2
+size_t shard_slots(int shard_count) {
+    size_t n = 1;
+    while (n < static_cast<size_t>(std::max(1, shard_count))) n *= 2;
+    return n;
+}
+
+} // namespace
+
+TileCache::TileCache(size_t capacity_bytes, int shard_count)
+    : capacity(capacity_bytes), shards(shard_slots(shard_count))
+{
+    shard_capacity = capacity / shards.size();
+}
+
+TileCache::shard& TileCache::shard_for(uint64_t key) {
+    return shards[mix(key) & (shards.size() - 1)];
+}
+
+TileCache::tile_ptr TileCache::find(uint64_t key) {
+    shard& s = shard_for(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    auto it = s.index.find(key);
+    if (it == s.index.end()) {
+        s.misses++;
+        return nullptr;
+    }
+    s.hits++;
+    s.lru.splice(s.lru.begin(), s.lru, it->second);
+    return it->second->second;
+}
+
+TileCache::tile_ptr TileCache::insert(uint64_t key, tile_ptr loaded) {
+    shard& s = shard_for(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    auto it = s.index.find(key);
+    if (it != s.index.end()) return it->second->second;
+
+    s.bytes_loaded += loaded->size();
+    s.bytes += loaded->size();
+    s.lru.emplace_front(key, loaded);
+    s.index.emplace(key, s.lru.begin());
+
+    // O tile recém-inserido fica mesmo que sozinho passe do limite
+    while (s.bytes > shard_capacity && s.lru.size() > 1) {
+        auto& victim = s.lru.back();
+        s.bytes -= victim.second->size();
+        s.index.erase(victim.first);
+        s.lru.pop_back();
+        s.evictions++;
+    }
+    return loaded;
+}
+
+TileCacheStats TileCache::stats() const {
+    TileCacheStats total;
+    for (const shard& s : shards) {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        total.hits += s.hits;
+        total.misses += s.misses;
+        total.evictions += s.evictions;
+        total.bytes_loaded += s.bytes_loaded;
+        total.bytes_resident += s.bytes;
+    }
+    return total;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @struct TileCacheStats
+ * @brief Contadores acumulados de um `TileCache`
+ */
+struct TileCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t bytes_loaded = 0;  // Lidos do disco nas faltas
+    size_t bytes_resident = 0;  // Em memória agora
+
+    double hit_rate() const {
+        return hits + misses ? double(hits) / double(hits + misses) : 0;
+    }
+};
+
+/**
+ * @class TileCache
+ * @brief Cache LRU de tiles de textura com limite de memória, compartilhado entre threads
+ *
+ * A chave de um tile junta textura, nível de mip e posição (`key`). O cache
+ * é dividido em fatias (shards) escolhidas pelo hash da chave, cada uma com
+ * seu mutex, sua lista LRU e `capacity / shards` bytes: threads que buscam
+ * tiles diferentes quase nunca disputam a mesma trava.
+ *
+ * Os tiles são `shared_ptr`: um tile despejado continua válido para quem
+ * ainda o está lendo, e a memória volta quando a última referência some.
+ * O carregamento acontece fora da trava; se duas threads carregam o mesmo
+ * tile ao mesmo tempo, a segunda usa o que a primeira inseriu.
+ */
+class TileCache {
+public:
+    using tile = std::vector<uint8_t>;
+    using tile_ptr = std::shared_ptr<const tile>;
+
+    /**
+     * @param capacity_bytes Memória máxima dos tiles (somada entre as fatias)
+     * @param shard_count Número de fatias (arredondado para cima até uma potência de 2)
+     */
+    explicit TileCache(size_t capacity_bytes, int shard_count = 16);
+
+    TileCache(const TileCache&) = delete;
+    TileCache& operator=(const TileCache&) = delete;
+
+    /// Identificador novo para as chaves de uma textura
+    uint32_t register_texture() { return next_texture++; }
+
+    /// Chave do tile (x, y) do nível `level` da textura `texture_id`
+    static uint64_t key(uint32_t texture_id, int level, int x, int y) {
+        return (uint64_t(texture_id) << 48) | (uint64_t(level) << 42) | (uint64_t(y) << 21) | uint64_t(x);
+    }
+
+    /// O tile, se estiver no cache (conta como acerto e o torna o mais recente)
+    tile_ptr find(uint64_t key);
+
+    /**
+     * @brief Adiciona um tile recém-carregado, despejando os menos recentes da fatia
+     * @return O tile que ficou no cache (o de outra thread, se ela chegou antes)
+     */
+    tile_ptr insert(uint64_t key, tile_ptr loaded);
+
+    TileCacheStats stats() const;
+
+    const size_t capacity;
+
+private:
+    struct alignas(64) shard {
+        mutable std::mutex mutex;
+        std::list<std::pair<uint64_t, tile_ptr>> lru; // Mais recente na frente
+        std::unordered_map<uint64_t, std::list<std::pair<uint64_t, tile_ptr>>::iterator> index;
+        size_t bytes = 0;
+        uint64_t hits = 0, misses = 0, evictions = 0, bytes_loaded = 0;
+    };
+
+    shard& shard_for(uint64_t key);
+
+    std::vector<shard> shards;
+    size_t shard_capacity;
+    std::atomic<uint32_t> next_texture{0};
+};
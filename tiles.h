@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Ordem em que os tiles da imagem são percorridos (e guardados na memória)
+ */
+enum class TileOrder {
+    Scanline, ///< Linha a linha, da esquerda para a direita
+    Morton    ///< Curva Z: tiles vizinhos na ordem também são vizinhos na imagem
+};
+
+/**
+ * @struct Tile
+ * @brief Retângulo de pixels `[x0, x1) x [y0, y1)` (y = 0 é a linha de baixo)
+ */
+struct Tile {
+    int x0, y0;
+    int x1, y1;
+};
+
+/**
+ * @brief Intercala os bits de x e y (código de Morton / curva Z)
+ */
+inline uint32_t morton_encode(uint32_t x, uint32_t y) {
+    auto spread = [](uint32_t v) {
+        v &= 0x0000ffff;
+        v = (v | (v << 8)) & 0x00ff00ff;
+        v = (v | (v << 4)) & 0x0f0f0f0f;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1);
+}
+
+/**
+ * @brief Lista as coordenadas (tx, ty) dos tiles de uma grade na ordem pedida
+ *
+ * @return Vetor com `tx + ty * tiles_x` de cada tile, na ordem de percurso
+ */
+inline std::vector<int> tile_order(int tiles_x, int tiles_y, TileOrder order) {
+    std::vector<int> ids(tiles_x * tiles_y);
+    for (int k = 0; k < tiles_x * tiles_y; ++k) ids[k] = k;
+
+    if (order == TileOrder::Morton) {
+        // Em grades que não são potência de 2 a curva tem "saltos", mas a ordem relativa continua local
+        std::sort(ids.begin(), ids.end(), [tiles_x](int a, int b) {
+            return morton_encode(a % tiles_x, a / tiles_x) < morton_encode(b % tiles_x, b / tiles_x);
+        });
+    }
+    return ids;
+}
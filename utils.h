@@ -4,6 +4,7 @@
 #include <limits>
 #include <memory>
 #include <cstdlib> 
+#include "random.h"
 
 using std::shared_ptr;
 using std::make_shared;
@@ -27,26 +28,6 @@ inline double degrees_to_radians(double degrees) {
     return degrees * pi / 180.0;
 }
 
-/**
- * @brief Gera um número real aleatório no intervalo [0, 1)
- *
- * @return Número aleatório entre 0 (inclusive) e 1 (exclusive).
- */
-inline double random_double() {
-    return rand() / (RAND_MAX + 1.0);
-}
-
-/**
- * @brief Gera um número real aleatório no intervalo [min, max)
- *
- * @param min Limite inferior
- * @param max Limite superior
- * @return Número aleatório entre `min` (inclusive) e `max` (exclusive)
- */
-inline double random_double(double min, double max) {
-    return min + (max-min)*random_double();
-}
-
 /**
  * @brief Limita o valor de `x` ao intervalo [min, max].
  *
@@ -17,6 +17,7 @@
 #include <cmath>
 #include <iostream>
 #include <cstdlib>
+#include "random.h"
 
 using std::sqrt;
 using namespace std;
@@ -197,9 +198,7 @@ inline vec3 unit_vector(const vec3& v) {
  * @brief Gera um vetor aleatório dentro do intervalo [0,1)
  */
 inline vec3 random_vec3() {
-    return vec3(rand() / (RAND_MAX + 1.0), 
-                rand() / (RAND_MAX + 1.0), 
-                rand() / (RAND_MAX + 1.0));
+    return vec3(random_double(), random_double(), random_double());
 }
 
 /**
@@ -208,8 +207,7 @@ inline vec3 random_vec3() {
  * @param max Valor máximo
  */
 inline vec3 random_vec3(double min, double max) {
-    auto r = [=]() { return min + (max-min)*(rand() / (RAND_MAX + 1.0)); };
-    return vec3(r(), r(), r());
+    return vec3(random_double(min, max), random_double(min, max), random_double(min, max));
 }
 
 /**
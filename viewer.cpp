@@ -0,0 +1,252 @@
+// Visualizador remoto do `raytracer --serve`: mostra os quadros recebidos
+// numa janela SDL e devolve as teclas WASD para mover a câmera do servidor.
+//
+//   rtviewer [host] [porta] [--bench <segundos>]
+//
+// Com --bench, aperta `a` e `d` alternadamente a cada segundo (sem precisar
+// de ninguém no teclado), sai depois do tempo dado e mostra banda e latência.
+
+#include "window.h"
+#include "frame_stream.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using clock_type = std::chrono::steady_clock;
+
+namespace {
+
+// Limites do que o visualizador aceita do servidor: nada que chega pela rede
+// indexa a imagem ou dimensiona um buffer sem passar por eles
+const int32_t max_side = 16384;
+const uint32_t max_title_bytes = 4096;
+
+/// Maior saída possível de `encode_tile`: só literais, 1 byte de controle a cada 128
+size_t max_tile_bytes(int width, int height) {
+    const size_t count = static_cast<size_t>(width) * height;
+    return 3 * (count + (count + 127) / 128);
+}
+
+/// O tile cabe na imagem e os dados cabem no pior caso da compressão
+bool valid_tile(const StreamTile& tile, int width, int height) {
+    return tile.width > 0 && tile.height > 0
+        && tile.x + tile.width <= width && tile.y + tile.height <= height
+        && tile.bytes <= max_tile_bytes(tile.width, tile.height);
+}
+
+bool recv_all(int fd, void* data, size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = recv(fd, p, size, 0);
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int connect_to(const std::string& host, const std::string& port) {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* list = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &list) != 0) return -1;
+
+    int fd = -1;
+    for (addrinfo* a = list; a && fd < 0; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(list);
+    return fd;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    size_t k = std::min(values.size() - 1, static_cast<size_t>(p / 100 * values.size()));
+    return values[k];
+}
+
+/// Estado compartilhado entre a thread de rede e a da janela
+struct Shared {
+    std::mutex mutex;
+    std::vector<uint32_t> image;
+    std::string title;
+    uint32_t input_seq = 0;
+    bool updated = false;
+    std::atomic<bool> closed{false};
+
+    // Estatísticas (só a thread de rede escreve)
+    uint64_t frames = 0, tiles = 0, bytes = 0, raw_bytes = 0;
+};
+
+/**
+ * @brief Lê quadros até a conexão cair (ou o servidor mandar algo inválido)
+ *
+ * Os tiles são recebidos e aplicados numa cópia própria da imagem, sem
+ * travar `shared.mutex`: a janela continua tratando eventos e enviando
+ * teclas enquanto um quadro chega. Só o quadro completo é copiado para
+ * `shared.image`.
+ */
+void receive_frames(int fd, int width, int height, Shared& shared) {
+    std::vector<uint8_t> data;
+    std::string title;
+    std::vector<uint32_t> image(size_t(width) * height, 0xff000000u);
+    while (true) {
+        StreamFrame frame;
+        if (!recv_all(fd, &frame, sizeof(frame))) break;
+        if (frame.title_bytes > max_title_bytes) {
+            std::fprintf(stderr, "Título de quadro grande demais (%u bytes); desconectando\n", frame.title_bytes);
+            break;
+        }
+        title.resize(frame.title_bytes);
+        if (!recv_all(fd, &title[0], title.size())) break;
+
+        uint64_t bytes = sizeof(frame) + title.size(), raw = 0;
+        bool ok = true;
+        for (uint32_t k = 0; k < frame.tile_count && ok; ++k) {
+            StreamTile tile;
+            ok = recv_all(fd, &tile, sizeof(tile));
+            if (!ok) break;
+            if (!valid_tile(tile, width, height)) {
+                std::fprintf(stderr, "Tile inválido (%ux%u em %u,%u, %u bytes); desconectando\n",
+                             tile.width, tile.height, tile.x, tile.y, tile.bytes);
+                ok = false;
+                break;
+            }
+            data.resize(tile.bytes);
+            ok = recv_all(fd, data.data(), data.size())
+              && decode_tile(data.data(), data.size(), &image[size_t(tile.y) * width + tile.x],
+                             width, tile.width, tile.height);
+            bytes += sizeof(tile) + tile.bytes;
+            raw += 3ull * tile.width * tile.height;
+        }
+        if (!ok) break;
+
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.image = image;
+        shared.title = title;
+        shared.input_seq = frame.input_seq;
+        shared.updated = true;
+        shared.frames++;
+        shared.tiles += frame.tile_count;
+        shared.bytes += bytes;
+        shared.raw_bytes += raw;
+    }
+    shared.closed = true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string host = "127.0.0.1", port = "7878";
+    double bench_seconds = 0;
+    std::vector<std::string> positional;
+    for (int k = 1; k < argc; ++k) {
+        std::string arg = argv[k];
+        if (arg == "--bench" && k + 1 < argc)
+            bench_seconds = std::stod(argv[++k]);
+        else
+            positional.push_back(arg);
+    }
+    if (positional.size() > 0) host = positional[0];
+    if (positional.size() > 1) port = positional[1];
+
+    int fd = connect_to(host, port);
+    StreamHello hello;
+    if (fd < 0 || !recv_all(fd, &hello, sizeof(hello)) || std::memcmp(hello.magic, stream_magic, 4) != 0) {
+        std::fprintf(stderr, "Não foi possível conectar a %s:%s\n", host.c_str(), port.c_str());
+        return 1;
+    }
+    if (hello.width <= 0 || hello.height <= 0 || hello.width > max_side || hello.height > max_side) {
+        std::fprintf(stderr, "Tamanho de imagem inválido vindo de %s:%s: %dx%d\n", host.c_str(), port.c_str(),
+                     int(hello.width), int(hello.height));
+        close(fd);
+        return 1;
+    }
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+    Shared shared;
+    shared.image.assign(size_t(hello.width) * hello.height, 0xff000000u);
+    std::thread network(receive_frames, fd, hello.width, hello.height, std::ref(shared));
+
+    Window window(hello.width, hello.height);
+    std::map<uint32_t, clock_type::time_point> pending; // Teclas enviadas e ainda não vistas
+    std::vector<double> latencies;
+    uint32_t seq = 0;
+
+    auto start = clock_type::now();
+    auto last_bench_key = start;
+    while (!window.should_close() && !shared.closed) {
+        auto now = clock_type::now();
+        std::string keys = window.poll_keys();
+        if (bench_seconds > 0) {
+            if (std::chrono::duration<double>(now - start).count() >= bench_seconds) break;
+            if (now - last_bench_key >= std::chrono::seconds(1)) {
+                keys += seq % 2 ? 'd' : 'a';
+                last_bench_key = now;
+            }
+        }
+        for (char key : keys) {
+            StreamKey message{++seq, key};
+            pending[message.seq] = clock_type::now();
+            if (send(fd, &message, sizeof(message), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(message)))
+                shared.closed = true;
+        }
+
+        uint32_t shown_seq = 0;
+        bool show = false;
+        {
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            if (shared.updated) {
+                std::copy(shared.image.begin(), shared.image.end(), window.pixel_buffer());
+                window.set_title(shared.title);
+                shown_seq = shared.input_seq;
+                shared.updated = false;
+                show = true;
+            }
+        }
+        if (show) {
+            window.refresh();
+            // Latência: da tecla até a tela mostrar um quadro que já a inclui
+            auto shown = clock_type::now();
+            while (!pending.empty() && pending.begin()->first <= shown_seq) {
+                latencies.push_back(std::chrono::duration<double, std::milli>(shown - pending.begin()->second).count());
+                pending.erase(pending.begin());
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    shutdown(fd, SHUT_RDWR);
+    network.join();
+    close(fd);
+
+    double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    std::printf("%llu quadros, %llu tiles, %.2f MB recebidos em %.1f s (%.2f MB/s), compressão %.2fx\n",
+                (unsigned long long)shared.frames, (unsigned long long)shared.tiles, shared.bytes / 1e6, seconds,
+                shared.bytes / 1e6 / seconds, shared.bytes ? double(shared.raw_bytes) / shared.bytes : 0.0);
+    if (!latencies.empty())
+        std::printf("Latência tecla -> tela (%zu teclas): p50 %.1f ms, p99 %.1f ms\n",
+                    latencies.size(), percentile(latencies, 50), percentile(latencies, 99));
+    return 0;
+}
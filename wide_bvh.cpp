@@ -0,0 +1,300 @@
+#include "wide_bvh.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Cada nó empilha até 8 filhos: cabe uma árvore binária de profundidade ~140
+const int stack_size = 1024;
+
+// Folga relativa no t de saída: cobre o arredondamento do teste em float
+const float exit_padding = 1.0f + 1.0f / (1 << 20);
+
+// Menor expoente de quantização (a escala continua sendo um float normal)
+const int min_exponent = -100;
+
+/// 2^e como float, montando os bits do expoente direto
+inline float exp2i(int e) {
+    uint32_t bits = static_cast<uint32_t>(e + 127) << 23;
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+struct stack_entry {
+    uint32_t ref;  // Nó interno ou folha (com wide_bvh::leaf_flag)
+    float t_near;  // Entrada na caixa: descartado se já houver hit mais próximo
+};
+
+} // namespace
+
+wide_bvh::wide_bvh(const bvh& tree) : objects(tree.objects), unbounded(tree.unbounded) {
+    if (tree.nodes.empty()) return;
+
+    box = tree.nodes[0].box;
+    nodes.reserve(tree.nodes.size() / 3 + 1);
+    prims.reserve(tree.refs.size());
+    collapse(tree, 0);
+}
+
+uint32_t wide_bvh::collapse(const bvh& tree, uint32_t binary_index) {
+    // Abre o filho interno de maior área até ter 8 filhos
+    std::vector<uint32_t> children;
+    const bvh::node& root = tree.nodes[binary_index];
+    if (root.is_leaf()) {
+        children.push_back(binary_index);
+    } else {
+        children.push_back(root.child);
+        children.push_back(root.child + 1);
+    }
+
+    while (children.size() < 8) {
+        int best = -1;
+        double best_area = -1;
+        for (size_t k = 0; k < children.size(); ++k) {
+            const bvh::node& c = tree.nodes[children[k]];
+            if (!c.is_leaf() && c.box.surface_area() > best_area) {
+                best_area = c.box.surface_area();
+                best = static_cast<int>(k);
+            }
+        }
+        if (best < 0) break;
+
+        uint32_t opened = children[best];
+        children[best] = tree.nodes[opened].child;
+        children.push_back(tree.nodes[opened].child + 1);
+    }
+
+    std::vector<aabb> boxes;
+    for (uint32_t c : children) boxes.push_back(tree.nodes[c].box);
+
+    const uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+    quantize(nodes[index], boxes);
+
+    for (size_t k = 0; k < children.size(); ++k) {
+        const bvh::node& c = tree.nodes[children[k]];
+        uint32_t ref;
+        if (c.is_leaf()) {
+            ref = leaf_flag | (c.prim_count - 1) << 27 | static_cast<uint32_t>(prims.size());
+            for (uint32_t s = c.prim_begin; s < c.prim_begin + c.prim_count; ++s)
+                prims.push_back(tree.refs[s].object);
+        } else {
+            ref = collapse(tree, children[k]);
+        }
+        nodes[index].child[k] = ref; // `nodes` pode ter sido realocado por collapse
+    }
+
+    return index;
+}
+
+void wide_bvh::quantize(node& n, const std::vector<aabb>& boxes) const {
+    std::memset(&n, 0, sizeof(n));
+
+    aabb parent;
+    for (const aabb& b : boxes) parent.expand(b);
+
+    for (int a = 0; a < 3; ++a) {
+        const double lo = parent.min()[a];
+        const double hi = parent.max()[a];
+
+        // Origem arredondada para baixo e a menor escala 2^e que cobre o pai em 255 passos
+        float origin = static_cast<float>(lo);
+        if (origin > lo) origin = std::nextafter(origin, -std::numeric_limits<float>::infinity());
+
+        int e = min_exponent;
+        if (hi - origin > 0) {
+            std::frexp((hi - origin) / 255.0, &e);
+            e = std::max(e, min_exponent);
+        }
+        while (origin + 255 * std::ldexp(1.0, e) < hi) e++;
+
+        const double scale = std::ldexp(1.0, e);
+        n.origin[a] = origin;
+        n.exponent[a] = static_cast<int8_t>(e);
+
+        // Limites arredondados para fora
+        for (size_t k = 0; k < boxes.size(); ++k) {
+            double cmin = boxes[k].min()[a], cmax = boxes[k].max()[a];
+
+            int qlo = static_cast<int>(std::clamp(std::floor((cmin - origin) / scale), 0.0, 255.0));
+            while (qlo > 0 && origin + qlo * scale > cmin) qlo--;
+
+            int qhi = static_cast<int>(std::clamp(std::ceil((cmax - origin) / scale), 0.0, 255.0));
+            while (qhi < 255 && origin + qhi * scale < cmax) qhi++;
+
+            n.qlo[a][k] = static_cast<uint8_t>(qlo);
+            n.qhi[a][k] = static_cast<uint8_t>(qhi);
+        }
+    }
+
+    n.valid = static_cast<uint8_t>((1u << boxes.size()) - 1);
+}
+
+wide_bvh::ray_data wide_bvh::prepare(const ray& r) {
+    ray_data rd;
+    for (int a = 0; a < 3; ++a) {
+        float d = static_cast<float>(r.direction()[a]);
+        if (std::fabs(d) < 1e-20f) d = std::copysign(1e-20f, d); // Evita 0 * inf no teste
+        rd.origin[a] = static_cast<float>(r.origin()[a]);
+        rd.inv_dir[a] = 1.0f / d;
+        rd.negative[a] = rd.inv_dir[a] < 0;
+    }
+    return rd;
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+unsigned wide_bvh::intersect_children(const node& n, const ray_data& rd, float t_min, float t_max,
+                                      float t_near[8]) {
+    __m256 t0 = _mm256_set1_ps(t_min);
+    __m256 t1 = _mm256_set1_ps(t_max);
+
+    for (int a = 0; a < 3; ++a) {
+        // t = q * (2^e / d) + (origin - o) / d
+        const __m256 scale = _mm256_set1_ps(exp2i(n.exponent[a]) * rd.inv_dir[a]);
+        const __m256 offset = _mm256_set1_ps((n.origin[a] - rd.origin[a]) * rd.inv_dir[a]);
+
+        const uint8_t* q_near = rd.negative[a] ? n.qhi[a] : n.qlo[a];
+        const uint8_t* q_far = rd.negative[a] ? n.qlo[a] : n.qhi[a];
+        __m256 near = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(q_near))));
+        __m256 far = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(q_far))));
+
+        t0 = _mm256_max_ps(t0, _mm256_fmadd_ps(near, scale, offset));
+        t1 = _mm256_min_ps(t1, _mm256_fmadd_ps(far, scale, offset));
+    }
+
+    t1 = _mm256_mul_ps(t1, _mm256_set1_ps(exit_padding));
+    _mm256_storeu_ps(t_near, t0);
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(t0, t1, _CMP_LE_OQ))) & n.valid;
+}
+
+#else
+
+unsigned wide_bvh::intersect_children(const node& n, const ray_data& rd, float t_min, float t_max,
+                                      float t_near[8]) {
+    float scale[3], offset[3];
+    for (int a = 0; a < 3; ++a) {
+        scale[a] = exp2i(n.exponent[a]) * rd.inv_dir[a];
+        offset[a] = (n.origin[a] - rd.origin[a]) * rd.inv_dir[a];
+    }
+
+    unsigned mask = 0;
+    for (int k = 0; k < 8; ++k) {
+        float t0 = t_min, t1 = t_max;
+        for (int a = 0; a < 3; ++a) {
+            float q_near = rd.negative[a] ? n.qhi[a][k] : n.qlo[a][k];
+            float q_far = rd.negative[a] ? n.qlo[a][k] : n.qhi[a][k];
+            t0 = std::max(t0, q_near * scale[a] + offset[a]);
+            t1 = std::min(t1, q_far * scale[a] + offset[a]);
+        }
+        t_near[k] = t0;
+        if (t0 <= t1 * exit_padding) mask |= 1u << k;
+    }
+    return mask & n.valid;
+}
+
+#endif
+
+bool wide_bvh::hit(const ray& r, double t_min, double t_max, hit_record& rec) const {
+    bool hit_anything = false;
+    double closest_so_far = t_max;
+
+    for (const auto& object : unbounded) {
+        if (object->hit(r, t_min, closest_so_far, rec)) {
+            hit_anything = true;
+            closest_so_far = rec.t;
+        }
+    }
+    if (nodes.empty()) return hit_anything;
+
+    const ray_data rd = prepare(r);
+    const float near_limit = static_cast<float>(t_min);
+
+    stack_entry stack[stack_size];
+    int top = 0;
+    stack[top++] = {0, near_limit};
+
+    while (top > 0) {
+        const stack_entry entry = stack[--top];
+        if (entry.t_near > closest_so_far) continue;
+
+        if (entry.ref & leaf_flag) {
+            uint32_t first = entry.ref & 0x07ffffffu;
+            uint32_t count = ((entry.ref >> 27) & 0xfu) + 1;
+            for (uint32_t s = first; s < first + count; ++s) {
+                if (prims[s]->hit(r, t_min, closest_so_far, rec)) {
+                    hit_anything = true;
+                    closest_so_far = rec.t;
+                }
+            }
+            continue;
+        }
+
+        const node& n = nodes[entry.ref];
+        float t_near[8];
+        unsigned mask = intersect_children(n, rd, near_limit, static_cast<float>(closest_so_far), t_near);
+
+        // Ordena os filhos atingidos por distância (inserção: no máximo 8)
+        stack_entry hits[8];
+        int count = 0;
+        for (; mask; mask &= mask - 1) {
+            int k = __builtin_ctz(mask);
+            stack_entry e = {n.child[k], t_near[k]};
+            int pos = count++;
+            while (pos > 0 && hits[pos - 1].t_near < e.t_near) {
+                hits[pos] = hits[pos - 1];
+                pos--;
+            }
+            hits[pos] = e;
+        }
+
+        // Do mais distante para o mais próximo: o mais próximo sai primeiro da pilha
+        for (int k = 0; k < count; ++k) stack[top++] = hits[k];
+    }
+
+    return hit_anything;
+}
+
+bool wide_bvh::hit_any(const ray& r, double t_min, double t_max) const {
+    for (const auto& object : unbounded)
+        if (object->hit_any(r, t_min, t_max)) return true;
+    if (nodes.empty()) return false;
+
+    const ray_data rd = prepare(r);
+
+    uint32_t stack[stack_size];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const uint32_t ref = stack[--top];
+
+        if (ref & leaf_flag) {
+            uint32_t first = ref & 0x07ffffffu;
+            uint32_t count = ((ref >> 27) & 0xfu) + 1;
+            for (uint32_t s = first; s < first + count; ++s)
+                if (prims[s]->hit_any(r, t_min, t_max)) return true;
+            continue;
+        }
+
+        const node& n = nodes[ref];
+        float t_near[8];
+        unsigned mask = intersect_children(n, rd, static_cast<float>(t_min), static_cast<float>(t_max), t_near);
+        for (; mask; mask &= mask - 1) stack[top++] = n.child[__builtin_ctz(mask)];
+    }
+
+    return false;
+}
+
+bool wide_bvh::bounding_box(aabb& output_box) const {
+    if (!unbounded.empty() || nodes.empty()) return false;
+    output_box = box;
+    return true;
+}
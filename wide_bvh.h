@@ -0,0 +1,83 @@
+#pragma once
+
+#include "bvh.h"
+#include "arena.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using std::shared_ptr;
+
+/**
+ * @class wide_bvh
+ * @brief BVH de 8 filhos com caixas quantizadas em 8 bits
+ *
+ * Gerada colapsando uma `bvh` binária: cada nó absorve os netos de maior
+ * área até ter 8 filhos. As caixas dos filhos são guardadas relativas à
+ * caixa do pai como `origin + q * 2^exponent`, com `q` de 8 bits
+ * arredondado para fora (a caixa quantizada sempre contém a original).
+ *
+ * Cada nó ocupa 128 bytes alinhados a 64: a primeira linha de cache tem
+ * tudo o que o teste dos 8 filhos lê, a segunda as referências dos filhos.
+ * Com AVX2 os 8 filhos são testados de uma vez; sem AVX2, um a um.
+ *
+ * É uma cópia estática da árvore: depois de `bvh::refit`, construa outra.
+ */
+class wide_bvh : public hittable {
+public:
+    explicit wide_bvh(const bvh& tree);
+
+    virtual bool hit(const ray& r, double t_min, double t_max, hit_record& rec) const override;
+
+    virtual bool hit_any(const ray& r, double t_min, double t_max) const override;
+
+    virtual bool bounding_box(aabb& output_box) const override;
+
+    size_t node_count() const { return nodes.size(); }
+
+    /// Memória ocupada pelos nós
+    size_t memory_bytes() const { return nodes.size() * sizeof(node); }
+
+private:
+    struct alignas(64) node {
+        // Primeira linha de cache: caixas dos filhos
+        uint8_t qlo[3][8];  // Por eixo: limite inferior de cada filho
+        uint8_t qhi[3][8];  // Por eixo: limite superior de cada filho
+        float origin[3];
+        int8_t exponent[3];
+        uint8_t valid;      // Bit k ligado: o filho k existe
+
+        // Segunda linha: nó interno = índice do nó; folha = leaf_flag | (n - 1) << 27 | primeiro objeto
+        uint32_t child[8];
+    };
+    static_assert(sizeof(node) == 128, "wide_bvh::node deve ocupar duas linhas de cache");
+
+    static constexpr uint32_t leaf_flag = 0x80000000u;
+
+    // Raio convertido para float, com os dados repetidos em todo nó
+    struct ray_data {
+        float origin[3];
+        float inv_dir[3];
+        int negative[3]; // Direção negativa no eixo: planos próximos são os `qhi`
+    };
+
+    uint32_t collapse(const bvh& tree, uint32_t binary_index);
+    void quantize(node& n, const std::vector<aabb>& boxes) const;
+    static ray_data prepare(const ray& r);
+
+    /**
+     * @brief Testa os 8 filhos de um nó
+     *
+     * @param t_near Recebe o t de entrada de cada filho
+     * @return Máscara dos filhos atingidos dentro de `[t_min, t_max]`
+     */
+    static unsigned intersect_children(const node& n, const ray_data& rd, float t_min, float t_max,
+                                       float t_near[8]);
+
+private:
+    std::vector<shared_ptr<hittable>> objects;   // Mantém os objetos vivos
+    std::vector<shared_ptr<hittable>> unbounded;
+    aligned_vector<node> nodes;
+    std::vector<const hittable*> prims;          // Objetos das folhas, contíguos por folha
+    aabb box;
+};
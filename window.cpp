@@ -64,10 +64,20 @@ void Window::refresh() {
     SDL_RenderPresent(renderer);
 }
 
+void Window::set_title(const std::string& title) {
+    SDL_SetWindowTitle(window, title.c_str());
+}
+
 bool Window::process_input(camera& cam) {
-    SDL_Event e;
     bool moved = false;
-    double speed = 0.5;
+    for (char key : poll_keys())
+        moved = cam.move(key) || moved;
+    return moved;
+}
+
+std::string Window::poll_keys() {
+    SDL_Event e;
+    std::string keys;
 
     while (SDL_PollEvent(&e)) {
         if (e.type == SDL_QUIT) {
@@ -78,26 +88,14 @@ bool Window::process_input(camera& cam) {
                 case SDLK_ESCAPE:
                     should_close_flag = true;
                     break;
-                case SDLK_w:
-                    cam.move_forward(speed);
-                    moved = true;
-                    break;
-                case SDLK_s:
-                    cam.move_backward(speed);
-                    moved = true;
-                    break;
-                case SDLK_a:
-                    cam.move_left(speed);
-                    moved = true;
-                    break;
-                case SDLK_d:
-                    cam.move_right(speed);
-                    moved = true;
-                    break;
+                case SDLK_w: keys += 'w'; break;
+                case SDLK_s: keys += 's'; break;
+                case SDLK_a: keys += 'a'; break;
+                case SDLK_d: keys += 'd'; break;
             }
         }
     }
-    return moved;
+    return keys;
 }
 
 bool Window::should_close() { 
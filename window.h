@@ -2,15 +2,17 @@
 
 #include <SDL2/SDL.h>
 #include <vector>
+#include <string>
 #include <cstdint> 
 #include "color.h"
 #include "camera.h"
+#include "display.h"
 
 /**
  * @class Window
  * @brief Gerencia a janela, renderizador e buffer de pixels usando SDL2
  */
-class Window {
+class Window : public Display {
 
 public:
     /**
@@ -28,21 +30,37 @@ public:
      */
     void set_pixel(int x, int y, const color& pixel_color, int samples_per_pixel);
 
+    /**
+     * @brief Framebuffer interno: ARGB8888, `width x height`, linha 0 no topo
+     */
+    uint32_t* pixel_buffer() override { return pixels.data(); }
+
     /**
      * @brief Atualiza a janela com o conteúdo atual do framebuffer
      */
-    void refresh();
+    void refresh() override;
+
+    /**
+     * @brief Troca o título da janela
+     */
+    void set_title(const std::string& title) override;
 
     /**
      * @brief Processa eventos do teclado e movimenta a câmera
      * @return `true` se a câmera se moveu, `false` caso contrário
      */
-    bool process_input(camera& cam);
+    bool process_input(camera& cam) override;
+
+    /**
+     * @brief Processa eventos do teclado sem mexer em câmera nenhuma
+     * @return Teclas de movimento (`w`, `a`, `s`, `d`) apertadas, na ordem
+     */
+    std::string poll_keys();
 
     /**
      * @brief Indica se a janela deve ser fechada
      */
-    bool should_close();
+    bool should_close() override;
 
 private:
     int width, height;